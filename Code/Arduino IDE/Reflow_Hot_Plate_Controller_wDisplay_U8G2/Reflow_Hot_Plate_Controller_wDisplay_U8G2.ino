@@ -21,17 +21,23 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include <Arduino.h> 
-#include <Wire.h>
 #include <EEPROM.h>
 #include <PID_v1.h>
 #include <U8g2lib.h>
+#include <util/crc16.h>
+
+#include "standby_interlock.h"
 
 // Definitions for the rotary encoder
 #define encCLK_inp 2
 #define encDT_inp 3
 #define encSW_inp 4
-#define readCLK bitRead(PIND, 2)  //faster than digitalRead()
-#define readDT bitRead(PIND, 3)   //faster than digitalRead()
+#define ENC_ACCEL_MS 60      // Detent interval (ms) below which parameter edits step x ENC_ACCEL_STEP
+#define ENC_ACCEL_STEP 4
+#define ENC_FAST_MS 25       // Detent interval (ms) below which parameter edits step x ENC_FAST_STEP
+#define ENC_FAST_STEP 10
+#define BTN_LONG_MS 800      // Hold time (ms) for a long press
+#define BTN_QUEUE_SIZE 4     // Button event queue length (power of 2)
 
 // Definitions & Variables for the Thermistors
 #define THERMISTORPIN1 A0          // which analog pin to connect
@@ -53,22 +59,32 @@ int samples1[Numsamples];
 int samples2[Numsamples];
 double steinhart1 = 0.0;    // Thermistor Temperature Converted Value (deg C)
 double steinhart2 = 0.0;    // Thermistor Temperature Converted Value (deg C)
-double T1Disp = 0.0;        // Running T1 Temperature Display (update at running timer interval)
-double T2Disp = 0.0;        // Running T2 Temperature Display (update at running timer interval)
+double T1Disp = 0.0;        // T1 Temperature Display (update at running timer interval / idle thermistor read)
+double T2Disp = 0.0;        // T2 Temperature Display (update at running timer interval / idle thermistor read)
 double thermistor1Buffer = 0.0;   // Thermistor 1 temperature value buffer
 double thermistor2Buffer = 0.0;   // Thermistor 2 temperature value buffer
 bool thermistor1Fail = 0;   // Thermistor 1 Failure Flag
 bool thermistor2Fail = 0;   // Thermistor 2 Failure Flag
 
 // Rotary Encoder Operation Variables
-volatile int tempCounter = 0;
 volatile int menuCounter = 1;
 int protectedMenuCounter = 1;
 int previousMenuCounter = 0;
 volatile int selectCounter = 0;
 int protectedSelectCounter = 0;
 int previousSelectCounter = 0;
-bool encSW;
+bool encSW;                    // Set for one loop pass on a short press (button released before BTN_LONG_MS)
+
+// Button events - produced by the 1 kHz Timer2 debouncer, consumed by loop(). Single producer / single consumer, so the
+// ISR only ever writes the head & loop() only the tail and no locking is needed.
+#define BTN_NONE 0
+#define BTN_PRESS 1
+#define BTN_LONG 2
+#define BTN_RELEASE 3
+volatile uint8_t btnQueue[BTN_QUEUE_SIZE];
+volatile uint8_t btnQueueHead = 0;
+volatile uint8_t btnQueueTail = 0;
+bool btnLongFired = 0;         // Long press already handled - the following release is not a short press
 
 // Definitions for Menu Structure
 uint8_t menuIndex = 0;         // Initialize to 0, or Main menu
@@ -87,10 +103,30 @@ double wrkDouble = 0.0;
 uint8_t parametersReflow[7] = { 115, 100, 145, 155, 185, 180, 35 };  // T1, t1, T2, t2, T3, t3, Reflow Duration
 double parametersPID[6] = { 3.30, 0.02, 3.45, 3.30, 0.02, 3.45 };  // Kp1, Ki1, Kd1, Kp2, Ki2, Kd2
 
+// Process Options - ON/OFF flags & production settings (Process Options menu)
+uint8_t parametersProcess[9] = { 0, 0, 5, 50, 0, 0, 60, 2, 138 };   // Iterative Learning Enable, Standby SP (0 = OFF), Batch Size, Batch Re-Entry Temp,
+                                                                    // Batch Auto Start, Cooling Rate (0.1 C/s, 0 = passive), Safe To Remove Temp,
+                                                                    // Telemetry Period (0.1 s, 0 = OFF), Paste Liquidus Temp
+
 // EEPROM Intermediate Variables
-uint8_t parametersReflowREAD[7] = {0, 0, 0, 0, 0, 0, 0};
-int parametersPIDREAD[6] = {0, 0, 0, 0, 0, 0};
-int parametersPIDint[6] = {0, 0, 0, 0, 0, 0};
+bool saveQueued = 0;           // Save Config writes queued, waiting for the background writer to finish
+
+// Background EEPROM writer - queued jobs are written one byte per EE_READY interrupt, so a save costs the loop nothing
+// but the hardware write time (~3.3 ms per changed byte). Job data must stay untouched until the job's callback has run.
+#define EE_JOBS 8                   // Write queue length (power of 2)
+struct EepromJob {
+  int address;
+  const uint8_t *data;
+  uint8_t length;
+  void (*done)();                   // Completion callback, run from loop() (NULL = none)
+};
+EepromJob eeJobs[EE_JOBS];
+volatile uint8_t eeJobHead = 0;     // Next free slot (written by loop() only)
+volatile uint8_t eeJobTail = 0;     // Job being written (written by the ISR only)
+volatile uint8_t eeJobOffset = 0;   // Next byte of the job being written
+uint8_t eeJobServiced = 0;          // Finished jobs up to here have had their callbacks run
+uint8_t eeBytesQueued = 0;          // Progress of the current batch of jobs
+volatile uint8_t eeBytesWritten = 0;
 
 // PID Variables
 double pid_Setpoint;
@@ -99,722 +135,2848 @@ double pid2_Input, pid2_Output;  // Define PID Variables Loop 2
 
 // Running Execution Variables
 bool runningBuffer = 0;
-uint8_t runningState = 0;        // States: 1 = RAMP, 2 = SOAK, 3 = REFLOW RAMP, 4 = REFLOW, 5 = COOLING / COMPLETE
+uint8_t runningState = 0;        // States: 1 = RAMP, 2 = SOAK, 3 = REFLOW RAMP, 4 = REFLOW, 5 = COOLING, 6 = COMPLETE (SAFE TO REMOVE)
 unsigned long time_now = 0;
 int runningSecondCounter = 0;
 double initTempSnapshot = 25.0;
+#define RAMP_REF_TEMP 25.0      // Ambient reference temperature the RAMP segment slope is designed from
 uint8_t constTempSP = 35;       // Constant Temp Mode Temperature SP
 bool runningMode = 0;           // Run Mode variable: 0 = CONSTANT TEMP MODE, 1 = REFLOW PROFILE MODE, 
 
+// Iterative Learning Control (ILC) Variables
+// The reflow profile timeline (0 -> t3 + Reflow Hold) is down-sampled into ILC_BINS time bins. Each completed run refines a
+// per-plate feedforward vector (PWM counts) from the mean tracking error observed in each bin, which is added to the PID output
+// on the next run. The vector is stored in EEPROM together with a signature of the profile it was learned for.
+#define ILC_BINS 16                 // Number of time bins the reflow profile is down-sampled into
+#define ILC_GAIN 4                  // Learning gain (PWM counts per deg C of mean bin tracking error)
+#define ILC_LIMIT 100               // Max feedforward correction magnitude (PWM counts)
+#define EEPROM_ADDR_ILC 512         // ILC record: [0] profile signature, [1] iteration count, [2..] correction vectors
+int8_t ilcCorrection[2][ILC_BINS];  // Learned feedforward correction per plate & bin (PWM counts)
+int16_t ilcErrorSum[2][ILC_BINS];   // Tracking error accumulated per plate & bin during the current run (0.1 deg C)
+uint8_t ilcSampleCount[ILC_BINS];   // Number of 1 sec samples accumulated per bin during the current run
+uint8_t ilcIteration = 0;           // Number of completed learning runs for the stored profile
+int16_t ilcFeedforward[2] = { 0, 0 };  // Feedforward value currently applied to each plate (PWM counts)
+uint8_t ilcHeader[2];               // Signature & iteration count staged for the background EEPROM writer
+double trackingErrSqSum = 0.0;      // Sum of squared tracking error for both plates (deg C^2)
+unsigned int trackingSamples = 0;   // Number of tracking error samples in trackingErrSqSum
+double trackingRMS = 0.0;           // Tracking RMS error of the current / last run (deg C)
+
+// Batch Production Mode Variables - N back-to-back reflow cycles, each started once the plates cool below the Re-Entry Temp
+#define BATCH_PEAK_TOL 5.0          // Cycle PASS: both plate peaks within +/- this of T3 (deg C)
+#define BATCH_RMS_LIMIT 10.0        // Cycle PASS: tracking RMS at or below this (deg C)
+bool batchMode = 0;                 // Batch mode active flag
+bool batchNextRequest = 0;          // Request to (re)initialize the running state for the next batch cycle
+bool batchGateOpen = 0;             // Plates are below the Re-Entry Temp, next cycle may start
+uint8_t batchCycle = 0;             // Current cycle number (1 -> Batch Size)
+uint8_t batchPassCount = 0;         // Number of cycles that passed
+uint8_t batchFailCount = 0;         // Number of cycles that failed
+bool batchCyclePass = 0;            // Grade of the current cycle, logged with its run history record
+double runPeak1 = 0.0;              // Peak plate 1 temperature of the current / last run
+double runPeak2 = 0.0;              // Peak plate 2 temperature of the current / last run
+uint8_t runStartTemp[2] = { 0, 0 }; // Plate temperatures when the current / last run started
+uint8_t runTAL = 0;                 // Seconds both plates were at / above the Liquidus Temp in the current / last run
+uint8_t runMaxDelta = 0;            // Max temperature difference between the plates before COOLING in the current / last run
+
+// Cooling Segment Variables
+int coolStartSecond = 0;            // Running second counter value at the start of the COOLING state
+double coolPrevTemp = 0.0;          // Hottest plate temperature at the previous 1 sec sample
+double coolRate = 0.0;              // Measured cooling rate (C/s, positive = cooling) - live in COOLING, average once COMPLETE
+double coolRateMax = 0.0;           // Max measured 1 sec cooling rate of the current / last run (C/s) - logged in its run history record
+
+// Plate Heating Model Variables
+// Max heating rate of each plate at full power, linear in temperature between MODEL_T_LOW and MODEL_T_HIGH (heat loss grows
+// with temperature), plus the passive cooling rate. Refined from full-power / passive-cooling observations and kept in EEPROM.
+#define MODEL_T_LOW 25.0            // Model reference temperature, low point (deg C)
+#define MODEL_T_HIGH 200.0          // Model reference temperature, high point (deg C)
+#define MODEL_SAT_OUTPUT 250        // Plate output at or above which the plate is considered to be at full power
+#define MODEL_LMS_DIV 8             // Model update weight = 1 / MODEL_LMS_DIV per observation
+int plateModel[5] = { 150, 60, 150, 60, 50 };   // Plate 1 rate @ T_LOW, @ T_HIGH, Plate 2 rate @ T_LOW, @ T_HIGH, Passive cooling rate (0.01 C/s)
+double modelPrevTemp[2] = { 0.0, 0.0 };   // Plate temperatures at the previous 1 sec model sample
+uint8_t plateUnsaturated = 0;       // Bit per plate - set when the plate dropped below full power during the current 1 sec sample
+bool plateModelChanged = 0;         // Model refined during this run, save to EEPROM at the end of the run
+uint16_t predictedRunTime = 0;      // Pre-start prediction of the total run time incl. cooling (s)
+uint8_t infeasibleSegments = 0;     // Pre-start feasibility result - bit 0 = RAMP, 1 = SOAK, 2 = REFLOW RAMP, 3 = REFLOW
+
+// Run Trend Graph Variables
+// Plate temperatures are sampled over the run into a ring buffer at 1 deg C / LSB, one sample per pixel column of the graph
+// screen - the setpoint is not stored, it is recomputed from the profile for each column drawn. New samples are sent as 8
+// pixel wide tile columns instead of repainting the whole frame.
+#define GRAPH_SAMPLES 128           // Ring buffer length = graph width (pixels)
+#define GRAPH_T_MIN 20              // Temperature at the bottom of the graph (deg C)
+#define GRAPH_HEADROOM 10           // Graph top = T3 + GRAPH_HEADROOM (deg C)
+#define GRAPH_TOP_ROW 2             // First tile row (8 pixel page) of the plot area - rows 0 & 1 hold the numeric header
+uint8_t graphData[2][GRAPH_SAMPLES];  // T1, T2 samples (deg C)
+uint8_t graphHead = 0;              // Ring index of the oldest sample
+int graphFirstSecond = 0;           // Running second counter value of the oldest sample
+uint8_t graphCount = 0;             // Number of samples stored
+uint8_t graphDrawn = 0;             // Number of samples already on the display (0 = plot area must be redrawn)
+uint8_t graphInterval = 1;          // Seconds per sample
+int graphLastSecond = 0;            // Running second counter value at the last sample
+int graphHeaderSecond = -1;         // Running second counter value shown in the graph header
+uint8_t graphDirtyRows = 0;         // Bit per tile row waiting to be sent
+uint8_t graphTileFrom = 0;          // Tile column range of the plot area update in progress
+uint8_t graphTileTo = 0;
+
 
 // Create PID Object(s)
 PID hotPlate1PID(&pid1_Input, &pid1_Output, &pid_Setpoint, parametersPID[0], parametersPID[1], parametersPID[2], DIRECT);  // Set Proportional on Measurement (P on Error is default), and Direct acting
 PID hotPlate2PID(&pid2_Input, &pid2_Output, &pid_Setpoint, parametersPID[3], parametersPID[4], parametersPID[5], DIRECT);  // Set Proportional on Measurement (P on Error is default), and Direct acting
 
+// -----------------------------------------------------------
+// Interrupt driven I2C (TWI) transport for the OLED
+// -----------------------------------------------------------
+// u8x8 byte callback backed by a transmit queue that the TWI interrupt drains at 400 kHz, in place of the blocking Wire
+// library. Each u8x8 transfer is queued as [length][bytes...] and sent as one I2C transaction, so a page transfer overlaps
+// with control & acquisition work instead of spinning on every byte. The queue holds a full page plus command overhead,
+// and replaces the Wire / twi buffers (~160 bytes) it makes unnecessary.
+//
+// Wire's twi.c defines the same TWI interrupt vector, so the transport is only built with Wire out of the link: U8g2's own
+// HW I2C support, the only user of Wire, compiled out with U8X8_NO_HW_I2C. platformio.ini sets it (and lib_ignore's Wire),
+// in the Arduino IDE add "compiler.cpp.extra_flags=-DU8X8_NO_HW_I2C" to platform.local.txt (arduino-cli:
+// --build-property). A stock build, with U8X8_HAVE_HW_I2C defined by U8g2, falls back to U8g2's blocking Wire transport.
+#define TWI_FREQ 400000L
+#ifndef U8X8_HAVE_HW_I2C
+#define TWI_QUEUE_SIZE 160
+uint8_t twiQueue[TWI_QUEUE_SIZE];
+volatile uint8_t twiHead = 0;          // Next byte to send (TWI ISR)
+volatile uint8_t twiCommitted = 0;     // End of the completely queued transfers (ISR sends up to here)
+uint8_t twiTail = 0;                   // Next free byte (producer)
+uint8_t twiLengthIndex = 0;            // Length slot of the transfer being queued
+uint8_t twiLength = 0;                 // Number of bytes in the transfer being queued
+uint8_t twiAddress = 0x78;             // Display address (8-bit, write)
+volatile uint8_t twiRemaining = 0;     // Bytes left in the transaction in progress
+volatile bool twiBusy = 0;             // TWI transaction(s) in progress
+volatile uint16_t twiErrors = 0;       // NACK / arbitration lost count (diagnostics)
+
+uint8_t twiNext(uint8_t index) {
+  index++;
+  if (index >= TWI_QUEUE_SIZE) {
+    index = 0;
+  }
+  return index;
+}
+
+void twiPut(uint8_t data) {
+  uint8_t next = twiNext(twiTail);
+  while (next == twiHead) {}           // Queue full - wait for the TWI interrupt to drain a byte (u8x8 transfers are <= 32
+                                       // bytes, so the transfer being queued always fits once earlier ones are sent)
+  twiQueue[twiTail] = data;
+  twiTail = next;
+}
+
+// Start the next committed transaction (START, then the ISR sends SLA+W & data) - called with the TWI idle
+void twiKick() {
+  noInterrupts();
+  if (!twiBusy && twiHead != twiCommitted) {
+    twiBusy = 1;
+    TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWIE) | _BV(TWSTA);
+  }
+  interrupts();
+}
+
+ISR(TWI_vect) {
+  switch (TWSR & 0xF8) {
+    case 0x08:   // START sent
+    case 0x10:   // Repeated START sent
+      twiRemaining = twiQueue[twiHead];
+      twiHead = twiNext(twiHead);
+      TWDR = twiAddress;
+      TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWIE);
+      return;
+    case 0x18:   // SLA+W ACK
+    case 0x28:   // Data ACK
+      if (twiRemaining > 0) {
+        TWDR = twiQueue[twiHead];
+        twiHead = twiNext(twiHead);
+        twiRemaining--;
+        TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWIE);
+        return;
+      }
+      break;
+    default:     // SLA+W / data NACK, arbitration lost - drop the rest of the transaction
+      twiErrors++;
+      while (twiRemaining > 0) {
+        twiHead = twiNext(twiHead);
+        twiRemaining--;
+      }
+      break;
+  }
+  // Transaction complete - STOP, immediately followed by a START if another transaction is queued
+  if (twiHead != twiCommitted) {
+    TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWIE) | _BV(TWSTO) | _BV(TWSTA);
+  } else {
+    TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWSTO);
+    twiBusy = 0;
+  }
+}
+
+uint8_t u8x8_byte_twi_async(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr) {
+  uint8_t *data;
+
+  switch (msg) {
+    case U8X8_MSG_BYTE_INIT:
+      pinMode(SDA, INPUT_PULLUP);
+      pinMode(SCL, INPUT_PULLUP);
+      TWSR = 0;                                     // Prescaler 1
+      TWBR = ((F_CPU / TWI_FREQ) - 16) / 2;
+      TWCR = _BV(TWEN);
+      twiAddress = u8x8_GetI2CAddress(u8x8);
+      break;
+    case U8X8_MSG_BYTE_SET_DC:                      // Not used on I2C
+      break;
+    case U8X8_MSG_BYTE_START_TRANSFER:
+      twiLengthIndex = twiTail;
+      twiPut(0);                                    // Reserve the length slot
+      twiLength = 0;
+      break;
+    case U8X8_MSG_BYTE_SEND:
+      data = (uint8_t *)arg_ptr;
+      while (arg_int > 0) {
+        twiPut(*data++);
+        twiLength++;
+        arg_int--;
+      }
+      break;
+    case U8X8_MSG_BYTE_END_TRANSFER:
+      twiQueue[twiLengthIndex] = twiLength;
+      twiCommitted = twiTail;                       // Hand the complete transfer to the ISR
+      twiKick();
+      break;
+    default:
+      return 0;
+  }
+  return 1;
+}
+
+// u8x8 GPIO & delay callback - only the delays are needed (no reset line, the bus pins belong to the TWI hardware). Keeps
+// U8g2's Arduino callbacks, and with them Wire, out of the link.
+uint8_t u8x8_gpio_delay_twi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr) {
+  switch (msg) {
+    case U8X8_MSG_DELAY_MILLI:
+      delay(arg_int);
+      break;
+    case U8X8_MSG_DELAY_10MICRO:
+      delayMicroseconds(arg_int * 10);
+      break;
+  }
+  return 1;
+}
+
+// SH1106 128x64, page buffer mode, on the interrupt driven I2C transport
+class U8G2_SH1106_128X64_NONAME_1_TWI_ASYNC : public U8G2 {
+  public:
+    U8G2_SH1106_128X64_NONAME_1_TWI_ASYNC(const u8g2_cb_t *rotation) : U8G2() {
+      u8g2_Setup_sh1106_i2c_128x64_noname_1(&u8g2, rotation, u8x8_byte_twi_async, u8x8_gpio_delay_twi);
+    }
+};
+
+#endif
+
 // Create u8g2 object
-U8G2_SH1106_128X64_NONAME_1_HW_I2C u8g2(U8G2_R0, /* reset=*/U8X8_PIN_NONE);
+#ifdef U8X8_HAVE_HW_I2C
+U8G2_SH1106_128X64_NONAME_1_HW_I2C u8g2(U8G2_R0);
+#else
+U8G2_SH1106_128X64_NONAME_1_TWI_ASYNC u8g2(U8G2_R0);
+#endif
+
+// Display Render Model
+// Snapshot of every value the screens are drawn from. The display is only repainted when the snapshot differs from the one
+// last drawn, instead of re-rendering and re-sending all 8 pages on every loop pass.
+struct DisplayModel {
+  uint8_t menuIndex;
+  uint8_t menuCounter;
+  uint8_t curPos[2];
+  bool selectFlag;
+  bool platesHot;
+  bool thermistor1Fail;
+  bool thermistor2Fail;
+  bool startConfirm;
+  bool runningMode;
+  bool batchMode;
+  bool batchGateOpen;
+  uint8_t wrkInt;
+  double wrkDouble;
+  uint8_t runningState;
+  uint8_t batchCycle;
+  uint8_t batchPassCount;
+  uint8_t batchFailCount;
+  uint8_t saveProgress;
+  uint8_t profileActive;
+  uint8_t histShownIndex;
+  // Live values - must stay last: a change limited to these is sent as a field update (running screens)
+  int runningSecondCounter;
+  double T1Disp;
+  double T2Disp;
+  double pid_Setpoint;
+  double trackingRMS;
+  double coolRate;
+};
+DisplayModel dispShown;         // Model of the frame currently on the display (frozen while a frame is being sent)
+bool displayBusy = 0;           // Frame in progress - one 128x8 page (or tile row) is rendered & sent per loop pass
+#define DISPLAY_PAGES 0         // Frame drawn page by page through the u8g2 page buffer
+#define DISPLAY_TILES 1         // Frame drawn with u8x8 tile writes (text only screens)
+#define DISPLAY_FIELDS 2        // Live field update - only the tiles covering changed characters are re-sent
+uint8_t displayMode = DISPLAY_PAGES;
+uint16_t fieldDirtyTiles[8];    // Field update: bit per tile column to re-send, per page
+uint8_t tileRow = 0;            // Next tile row of a tile mode frame
+uint8_t tileRowsValid = 0;      // Bit per tile row - set while the row shows the text hashed in tileRowHash
+uint8_t tileRowHash[8];         // CRC8 of the text & inverse flag last sent to each tile row
+
+// Boot timing - reported once over the serial port when the first frame is on the display
+#define OLED_POWERUP_MS 250     // OLED power-up time - the startup work before the display init runs inside it
+unsigned long bootReadyMs = 0;       // setup() done - inputs, config, sensors & control ready (ms from sketch start)
+unsigned long bootFirstFrameMs = 0;  // First complete frame on the display (ms from sketch start)
+
+// Uncomment to print loop & display performance counters to the serial port once per second (diagnostic builds only)
+// #define PERF_STATS
+#ifdef PERF_STATS
+unsigned long perfWindowStart = 0;   // Start of the current 1 sec measurement window (ms)
+uint16_t perfLoopCount = 0;          // loop() passes in the current window
+uint16_t perfFrameCount = 0;         // Frames rendered in the current window
+unsigned long perfFrameMicros = 0;   // Time spent rendering frames in the current window (us)
+unsigned long perfSliceMaxMicros = 0;  // Longest single display slice (page render + send) in the current window (us)
+uint16_t perfSkippedDraws = 0;       // Text elements skipped by page clipping in the current window
+#endif
 
 // -----------------------------------------------------------
 // Interrupt handling routines for rotary encoder
 // -----------------------------------------------------------
-void isrEncCLK() {
-  if (readDT != readCLK) {
-    tempCounter++;
-  } else {
-    tempCounter--;
+// Full step quadrature decoder - row is the decoder state, column the pin state (CLK << 1 | DT). A step is only emitted
+// when the pins return to rest (both high) after passing through every Gray code state of a detent in order, so contact
+// bounce on one line just walks the state back & forth and is never counted.
+#define ENC_START 0x0
+#define ENC_CW_FINAL 0x1
+#define ENC_CW_BEGIN 0x2
+#define ENC_CW_NEXT 0x3
+#define ENC_CCW_BEGIN 0x4
+#define ENC_CCW_FINAL 0x5
+#define ENC_CCW_NEXT 0x6
+#define ENC_DIR_CW 0x10
+#define ENC_DIR_CCW 0x20
+
+const uint8_t encTable[7][4] PROGMEM = {
+  {ENC_START,     ENC_CW_BEGIN,  ENC_CCW_BEGIN, ENC_START},                  // ENC_START
+  {ENC_CW_NEXT,   ENC_START,     ENC_CW_FINAL,  ENC_START | ENC_DIR_CW},     // ENC_CW_FINAL
+  {ENC_CW_NEXT,   ENC_CW_BEGIN,  ENC_START,     ENC_START},                  // ENC_CW_BEGIN
+  {ENC_CW_NEXT,   ENC_CW_BEGIN,  ENC_CW_FINAL,  ENC_START},                  // ENC_CW_NEXT
+  {ENC_CCW_NEXT,  ENC_START,     ENC_CCW_BEGIN, ENC_START},                  // ENC_CCW_BEGIN
+  {ENC_CCW_NEXT,  ENC_CCW_FINAL, ENC_START,     ENC_START | ENC_DIR_CCW},    // ENC_CCW_FINAL
+  {ENC_CCW_NEXT,  ENC_CCW_FINAL, ENC_CCW_BEGIN, ENC_START},                  // ENC_CCW_NEXT
+};
+
+// Single pin change interrupt for CLK (PD2) & DT (PD3) - replaces the two attachInterrupt() handlers and their
+// dispatch overhead. Parameter edits are scaled by the time between detents so large values can be spun in quickly.
+ISR(PCINT2_vect) {
+  static uint8_t state = ENC_START;
+  static unsigned long lastDetent = 0;
+  uint8_t pins = PIND;
+  unsigned long now;
+  int step;
+
+  state = pgm_read_byte(&encTable[state & 0x0F][((pins >> 1) & 0x02) | ((pins >> 3) & 0x01)]);
+  if (!(state & (ENC_DIR_CW | ENC_DIR_CCW))) {
+    return;
   }
 
+  step = (state & ENC_DIR_CW) ? 1 : -1;
   if (selectFlag == 1) {
-    selectCounter += tempCounter;
+    now = millis();
+    if (now - lastDetent < ENC_FAST_MS) {
+      step *= ENC_FAST_STEP;
+    } else if (now - lastDetent < ENC_ACCEL_MS) {
+      step *= ENC_ACCEL_STEP;
+    }
+    lastDetent = now;
+    selectCounter += step;
   } else {
-    if ((tempCounter > 0) && (menuCounter < selectIndexMax)) {
+    if ((step > 0) && (menuCounter < selectIndexMax)) {
       menuCounter++;
-    } else if ((tempCounter < 0) && (menuCounter > 1)) {
+    } else if ((step < 0) && (menuCounter > 1)) {
       menuCounter--;
     }
   }
-  tempCounter = 0;
 }
 
-void isrEncDT() {
-  if (readCLK == readDT) {
-    tempCounter++;
+// -----------------------------------------------------------
+// Button debouncing & event queue
+// -----------------------------------------------------------
+void btnQueuePut(uint8_t event) {
+  uint8_t next = (btnQueueHead + 1) & (BTN_QUEUE_SIZE - 1);
+
+  if (next != btnQueueTail) {   // Drop the event if loop() has fallen that far behind
+    btnQueue[btnQueueHead] = event;
+    btnQueueHead = next;
+  }
+}
+
+uint8_t btnQueueGet() {
+  uint8_t event;
+
+  if (btnQueueTail == btnQueueHead) {
+    return BTN_NONE;
+  }
+  event = btnQueue[btnQueueTail];
+  btnQueueTail = (btnQueueTail + 1) & (BTN_QUEUE_SIZE - 1);
+  return event;
+}
+
+// 1 ms tick - the switch must read the same for 8 consecutive samples before a press / release is accepted. A long
+// press is reported once per hold, so holding the button no longer re-triggers it.
+ISR(TIMER2_COMPA_vect) {
+  static uint8_t history = 0xFF;
+  static uint16_t heldMs = 0;
+  static bool pressed = 0;
+
+  history = (history << 1) | bitRead(PIND, encSW_inp);
+  if (!pressed) {
+    if (history == 0x00) {
+      pressed = 1;
+      heldMs = 0;
+      btnQueuePut(BTN_PRESS);
+    }
+  } else if (history == 0xFF) {
+    pressed = 0;
+    btnQueuePut(BTN_RELEASE);
+  } else if (heldMs < BTN_LONG_MS && ++heldMs == BTN_LONG_MS) {
+    btnQueuePut(BTN_LONG);
+  }
+}
+
+// -----------------------------------------------------------
+// Serial Port & Binary Telemetry
+// -----------------------------------------------------------
+// The USB-UART is driven from a TX ring emptied by the UDRE interrupt (replaces HardwareSerial, which has no non-blocking
+// write). Text output - history dump, boot & PERF_STATS reports - waits for ring space. Telemetry frames never wait: a frame
+// that does not fit is skipped (visible to the host as a gap in the frame sequence numbers).
+#define UART_BAUD 115200
+#define UART_TX_SIZE 128            // TX ring length (power of 2)
+#define TLM_PERIOD_UNIT_MS 100      // Telemetry Period option unit - the option steps by 2, so 0.2 s (every control tick) is the fastest
+#define TLM_TYPE_SAMPLE 1
+uint8_t uartTxBuf[UART_TX_SIZE];
+volatile uint8_t uartTxHead = 0;    // Written by loop() only
+volatile uint8_t uartTxTail = 0;    // Written by the ISR only
+unsigned long tlmLastMs = 0;
+uint8_t tlmSequence = 0;
+
+// Telemetry sample - little endian, followed by a CRC-16/CCITT-FALSE of the payload, then COBS encoded & framed by 0x00
+// on both sides so text output between frames is skipped by the host
+struct TelemetryFrame {
+  uint8_t type;                     // TLM_TYPE_SAMPLE
+  uint8_t sequence;                 // Incremented per frame
+  uint32_t timestamp;               // millis()
+  uint16_t adc[2];                  // Raw thermistor ADC counts (average of the last read)
+  int16_t temp[2];                  // Filtered plate temperatures (0.1 C)
+  int16_t setpoint;                 // PID setpoint (0.1 C)
+  uint8_t output[2];                // Heater outputs applied (PWM counts)
+  uint8_t state;                    // runningState, 0 in constant temp mode
+  uint8_t flags;                    // Bit 0 = running, 1 = reflow mode, 2 = T1 fail, 3 = T2 fail
+} __attribute__((packed));
+
+ISR(USART_UDRE_vect) {
+  if (uartTxTail == uartTxHead) {
+    UCSR0B &= ~bit(UDRIE0);         // Ring empty
+    return;
+  }
+  UDR0 = uartTxBuf[uartTxTail];
+  uartTxTail = (uartTxTail + 1) & (UART_TX_SIZE - 1);
+}
+
+uint8_t uartTxFree() {
+  return (uartTxTail - uartTxHead - 1) & (UART_TX_SIZE - 1);
+}
+
+void uartPut(uint8_t c) {
+  uartTxBuf[uartTxHead] = c;
+  uartTxHead = (uartTxHead + 1) & (UART_TX_SIZE - 1);
+  UCSR0B |= bit(UDRIE0);
+}
+
+void uartBegin() {
+  UBRR0 = (F_CPU / 4 / UART_BAUD - 1) / 2;   // Double speed mode, as the Arduino core sets it up
+  UCSR0A = bit(U2X0);
+  UCSR0C = 0x06;                             // 8N1
+  UCSR0B = bit(TXEN0);
+}
+
+// Text output through the TX ring
+class UartTx : public Print {
+ public:
+  size_t write(uint8_t c) {
+    while (uartTxFree() == 0) {   // Wait for the ISR to make room
+    }
+    uartPut(c);
+    return 1;
+  }
+  using Print::write;
+};
+UartTx uart;
+
+// COBS encode (length < 254) - returns the encoded length, the output holds no 0x00 bytes
+uint8_t cobsEncode(const uint8_t *in, uint8_t length, uint8_t *out) {
+  uint8_t code = 1;
+  uint8_t codeIndex = 0;
+  uint8_t o = 1;
+
+  for (uint8_t i = 0; i < length; i++) {
+    if (in[i] == 0) {
+      out[codeIndex] = code;
+      codeIndex = o++;
+      code = 1;
+    } else {
+      out[o++] = in[i];
+      code++;
+    }
+  }
+  out[codeIndex] = code;
+  return o;
+}
+
+void tlmSend() {
+  uint8_t raw[sizeof(TelemetryFrame) + 2];
+  uint8_t out[sizeof(raw) + 3];
+  TelemetryFrame *frame = (TelemetryFrame *)raw;
+  uint16_t crc = 0xFFFF;
+  uint8_t i, n;
+
+  frame->type = TLM_TYPE_SAMPLE;
+  frame->sequence = tlmSequence++;
+  frame->timestamp = millis();
+  frame->adc[0] = 0;
+  frame->adc[1] = 0;
+  for (i = 0; i < Numsamples; i++) {
+    frame->adc[0] += samples1[i];
+    frame->adc[1] += samples2[i];
+  }
+  frame->adc[0] /= Numsamples;
+  frame->adc[1] /= Numsamples;
+  frame->temp[0] = constrain(steinhart1 * 10.0, -32000, 32000);
+  frame->temp[1] = constrain(steinhart2 * 10.0, -32000, 32000);
+  frame->setpoint = pid_Setpoint * 10.0;
+  frame->output[0] = constrain(pid1_Output + ilcFeedforward[0], 0, 255);
+  frame->output[1] = constrain(pid2_Output + ilcFeedforward[1], 0, 255);
+  frame->state = runningMode == 1 ? runningState : 0;   // runningState is left over from the last reflow run otherwise
+  frame->flags = running | (runningMode << 1) | (thermistor1Fail << 2) | (thermistor2Fail << 3);
+  for (i = 0; i < sizeof(TelemetryFrame); i++) {
+    crc = _crc_xmodem_update(crc, raw[i]);
+  }
+  raw[sizeof(TelemetryFrame)] = crc & 0xFF;
+  raw[sizeof(TelemetryFrame) + 1] = crc >> 8;
+
+  out[0] = 0;
+  n = cobsEncode(raw, sizeof(raw), out + 1) + 1;
+  out[n++] = 0;
+  if (uartTxFree() < n) {           // Never wait - skip the frame
+    return;
+  }
+  for (i = 0; i < n; i++) {
+    uartPut(out[i]);
+  }
+}
+
+void tlmService() {
+  unsigned long period = parametersProcess[7] * TLM_PERIOD_UNIT_MS;
+
+  if (period > 0 && millis() - tlmLastMs >= period) {
+    tlmLastMs += period;
+    if (millis() - tlmLastMs >= period) {   // Fell behind (long blocking operation / period changed) - resynchronize
+      tlmLastMs = millis();
+    }
+    tlmSend();
+  }
+}
+
+// -----------------------------------------------------------
+// EEPROM Read / Write handling routines
+// -----------------------------------------------------------
+// Write the next changed byte of the queue - bytes already holding the value are skipped without a write cycle
+ISR(EE_READY_vect) {
+  EepromJob *job;
+  uint8_t value;
+
+  while (eeJobTail != eeJobHead) {
+    job = &eeJobs[eeJobTail];
+    if (eeJobOffset == job->length) {
+      eeJobOffset = 0;
+      eeJobTail = (eeJobTail + 1) & (EE_JOBS - 1);
+      continue;
+    }
+    value = job->data[eeJobOffset];
+    EEAR = job->address + eeJobOffset;
+    eeJobOffset++;
+    eeBytesWritten++;
+    EECR |= bit(EERE);
+    if (EEDR != value) {
+      EEDR = value;
+      EECR |= bit(EEMPE);
+      EECR |= bit(EEPE);
+      return;
+    }
+  }
+  EECR &= ~bit(EERIE);          // Queue drained
+}
+
+// Run the callbacks of finished jobs & free their slots
+void eeWriterService() {
+  while (eeJobServiced != eeJobTail) {
+    if (eeJobs[eeJobServiced].done != NULL) {
+      eeJobs[eeJobServiced].done();
+    }
+    eeJobServiced = (eeJobServiced + 1) & (EE_JOBS - 1);
+  }
+  if (eeJobServiced == eeJobHead) {
+    eeBytesQueued = 0;
+    eeBytesWritten = 0;
+  }
+}
+
+// Configuration record - every saved setting in one block, validated by magic, layout version & CRC at boot. Records are
+// journaled: each save is appended to the next of CONFIG_SLOTS slots with an incremented sequence number and the previous
+// record is left untouched, so wear is spread over the slots & a save cut short by power loss just leaves the previous
+// record as the latest valid one.
+#define EEPROM_ADDR_CONFIG 0        // Config journal: CONFIG_SLOTS x ConfigRecord (0 - 383)
+#define CONFIG_SLOTS 8
+#define CONFIG_MAGIC 0x5248         // 'RH'
+#define CONFIG_VERSION 4            // Bump whenever ConfigRecord changes
+#define CONFIG_VERSION_OLDEST 2     // Oldest layout still loaded - see configProcessCount()
+struct ConfigRecord {
+  uint16_t magic;
+  uint8_t version;
+  uint16_t sequence;                // Incremented on every save - the valid record with the highest sequence is current
+  uint8_t reflow[7];                // parametersReflow
+  int16_t pid[6];                   // parametersPID x100
+  uint8_t process[9];               // parametersProcess
+  int16_t plateModel[5];
+  uint16_t crc;                     // CRC16 of the preceding bytes
+} __attribute__((packed));
+ConfigRecord configRecord;          // Staging buffer for the background writer & the boot load
+uint8_t configSlot = CONFIG_SLOTS - 1;   // Journal slot holding the current record (the first save goes to slot 0)
+uint16_t configSequence = 0;        // Sequence number of the current record
+
+// Reflow profile slots - a small index (active slot, name of each slot & the record holding it) and one record per slot plus
+// a spare. Only the index and the selected slot's record are ever read. The active profile is edited in parametersReflow &
+// saved back with the config. A save writes the spare record, then flips the index to it - the index is journaled in two
+// copies, the valid one with the higher sequence is current, so a save cut short by power loss leaves the previous index
+// pointing at the untouched previous record.
+#define EEPROM_ADDR_PROFILES 384    // Pre-journal index (ProfileIndexV1) - only read to migrate it (384 - 392)
+#define EEPROM_ADDR_PROFILE_RECORDS 393   // PROFILE_RECORDS x ProfileSlot (393 - 448)
+#define EEPROM_ADDR_PROFILE_INDEX 449     // 2 x ProfileIndex journal (449 - 480)
+#define PROFILE_SLOTS 6
+#define PROFILE_RECORDS (PROFILE_SLOTS + 1)   // One record per slot + the spare a save is written to
+#define PROFILE_MAGIC 0xA5
+#define PROFILE_EMPTY 0xFF          // Name id of an unused slot
+struct ProfileIndex {
+  uint8_t magic;
+  uint8_t sequence;                 // Incremented on every index write
+  uint8_t active;                   // Selected slot
+  uint8_t nameId[PROFILE_SLOTS];    // Index into profileNames, PROFILE_EMPTY = unused slot
+  uint8_t record[PROFILE_SLOTS];    // Record holding each slot's profile
+  uint8_t crc;                      // CRC8 of the preceding bytes
+} __attribute__((packed));
+struct ProfileIndexV1 {             // Index of the pre-journal layout - slot n in record n, rewritten in place on save
+  uint8_t magic;
+  uint8_t active;
+  uint8_t nameId[PROFILE_SLOTS];
+  uint8_t crc;
+} __attribute__((packed));
+struct ProfileSlot {
+  uint8_t reflow[7];                // parametersReflow
+  uint8_t crc;
+} __attribute__((packed));
+ProfileIndex profileIndex;          // Current index & staging buffer for the background writer
+ProfileSlot profileSlot;            // Staging buffer for the background writer & slot loads
+uint8_t profileIndexCopy = 1;       // Journal copy holding the current index (the first write goes to copy 0)
+uint8_t profileNameId = 0;          // Name of the active profile (edited on the profile screen)
+bool profileWriting = 0;            // Staging buffers queued for the background writer - not to be touched until written
+void (*profileSaveDone)() = NULL;   // Completion callback of the queued save
+
+// Run history - a ring of bit-packed run records, appended when a reflow run completes or ends on a fault. The newest
+// record is the valid one with the highest sequence number, found by scanning the ring once at boot.
+#define EEPROM_ADDR_HISTORY 768     // HIST_RECORDS x RunRecord (768 - 1017)
+#define HIST_RECORDS 25
+#define HIST_OK 0                   // Fault codes
+#define HIST_T1_FAIL 1
+#define HIST_T2_FAIL 2
+#define HIST_T1_T2_FAIL 3
+#define HIST_ABORTED 4
+#define HIST_SINGLE 0               // Batch grades
+#define HIST_BATCH_PASS 1
+#define HIST_BATCH_FAIL 2
+struct RunRecord {
+  uint8_t sequence;
+  uint32_t slot : 3;                // Profile slot
+  uint32_t startT1 : 7;             // Plate temperatures at the start (C, 127 max)
+  uint32_t startT2 : 7;
+  uint32_t peak : 9;                // Peak plate temperature (C)
+  uint32_t maxDelta : 6;            // Max difference between the plates (C, 63 max)
+  uint32_t tal : 8;                 // Time above liquidus (s, 255 max)
+  uint32_t fault : 3;               // HIST_ fault code
+  uint32_t duration : 11;           // Run time (s, 2047 max)
+  uint32_t batch : 2;               // HIST_ batch grade of the cycle, HIST_SINGLE outside a batch
+  uint32_t coolMax : 8;             // Max measured 1 sec cooling rate (0.1 C/s, 25.5 max)
+  uint8_t crc;                      // CRC8 of the preceding bytes
+} __attribute__((packed));
+RunRecord histRecord;               // Staging buffer for the background writer
+RunRecord histShown;                // Record shown on the history screen
+uint8_t histNext = 0;               // Ring slot the next record is written to
+uint8_t histSequence = 0;           // Sequence number of the next record
+uint8_t histCount = 0;              // Valid records in the ring
+uint8_t histView = 1;               // Record selected on the history screen (1 = newest)
+uint8_t histShownIndex = 0;         // Record loaded into histShown (0 = none)
+bool historyLogged = 0;             // Current run already has its record
+
+// Run checkpoints - the progress of a reflow run is written every CP_INTERVAL seconds to the next slot of a ring, so a
+// brown-out or watchdog reset mid-run can be resumed. Only the few bytes that changed are written each time.
+#define EEPROM_ADDR_CHECKPOINT 560  // CP_SLOTS x Checkpoint (560 - 767)
+#define CP_SLOTS 26
+#define CP_INTERVAL 10              // Checkpoint interval (s)
+#define CP_MAX_GAP 60               // Max estimated power-off time (s) a run can be resumed after
+struct Checkpoint {
+  uint8_t sequence;
+  uint8_t state;                    // runningState, 0 = no run in progress
+  uint16_t second;                  // runningSecondCounter
+  uint8_t setpoint;                 // pid_Setpoint (C)
+  uint8_t rampOrigin;               // initTempSnapshot (C) - origin of the RAMP line
+  uint8_t signature;                // ilcProfileSignature() of the profile being run
+  uint8_t crc;                      // CRC8 of the preceding bytes
+} __attribute__((packed));
+Checkpoint cpRecord;                // Newest checkpoint & staging buffer for the background writer
+uint8_t cpSlot = CP_SLOTS - 1;      // Ring slot of the newest checkpoint
+bool cpWriting = 0;                 // cpRecord queued for the background writer - not to be touched until written
+bool cpDeferred = 0;                // Checkpoint requested while cpWriting - written once the queued one has landed
+uint8_t cpDeferredState = 0;
+bool cpPending = 0;                 // Interrupted run found at boot, not yet resumed or aborted - warm standby stays off
+
+bool eeWriterBusy() {
+  return eeJobServiced != eeJobHead;
+}
+
+// Percentage of the queued bytes written so far
+uint8_t eeWriterProgress() {
+  if (eeBytesQueued == 0) {
+    return 100;
+  }
+  return (uint16_t)eeBytesWritten * 100 / eeBytesQueued;
+}
+
+void eeWrite(int address, const void *data, uint8_t length, void (*done)()) {
+  uint8_t next = (eeJobHead + 1) & (EE_JOBS - 1);
+
+  while (next == eeJobServiced) {   // Queue full - wait for the oldest job (the current writers never queue that many)
+    eeWriterService();
+  }
+  eeJobs[eeJobHead].address = address;
+  eeJobs[eeJobHead].data = (const uint8_t *)data;
+  eeJobs[eeJobHead].length = length;
+  eeJobs[eeJobHead].done = done;
+  eeBytesQueued += length;
+  eeJobHead = next;
+  EECR |= bit(EERIE);
+}
+
+uint16_t configCrc(const ConfigRecord &record) {
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < offsetof(ConfigRecord, crc); i++) {
+    crc = _crc16_update(crc, ((const uint8_t *)&record)[i]);
+  }
+  return crc;
+}
+
+// Snapshot the saved settings into the staging record & append it to the next journal slot as one block
+void configSave(void (*done)()) {
+  uint8_t i;
+
+  configSlot = (configSlot + 1) % CONFIG_SLOTS;
+  configSequence++;
+  configRecord.magic = CONFIG_MAGIC;
+  configRecord.version = CONFIG_VERSION;
+  configRecord.sequence = configSequence;
+  memcpy(configRecord.reflow, parametersReflow, sizeof(configRecord.reflow));
+  for (i = 0; i < 6; i++) {                             // PID parameters are stored as INT x100
+    configRecord.pid[i] = parametersPID[i] * 100.0 + 0.5;
+  }
+  memcpy(configRecord.process, parametersProcess, sizeof(configRecord.process));
+  for (i = 0; i < 5; i++) {
+    configRecord.plateModel[i] = plateModel[i];
+  }
+  configRecord.crc = configCrc(configRecord);
+  eeWrite(EEPROM_ADDR_CONFIG + configSlot * sizeof(ConfigRecord), &configRecord, sizeof(configRecord), done);
+}
+
+// Layout versions that can be loaded - older layouts only hold fewer Process Options (the ones added since keep their
+// defaults), 0 = not loadable
+uint8_t configProcessCount(uint8_t version) {
+  switch (version) {
+    case 2: return 7;               // Before the Telemetry Period
+    case 3: return 8;               // Before the Liquidus Temp
+    case CONFIG_VERSION: return sizeof(configRecord.process);
+  }
+  return 0;
+}
+
+// Read journal slot 'slot' as a record of layout 'version' into configRecord, moved to the current layout - false unless the
+// slot holds a valid record of that version
+bool configRead(uint8_t slot, uint8_t version) {
+  uint8_t count = configProcessCount(version);
+  uint8_t missing = sizeof(configRecord.process) - count;
+  uint8_t size = sizeof(ConfigRecord) - missing;
+  uint8_t *raw = (uint8_t *)&configRecord;
+  uint16_t crc = 0xFFFF;
+  uint8_t i;
+
+  if (count == 0) {
+    return false;
+  }
+  for (i = 0; i < size; i++) {
+    raw[i] = EEPROM.read(EEPROM_ADDR_CONFIG + slot * size + i);
+    if (i < size - 2) {
+      crc = _crc16_update(crc, raw[i]);
+    }
+  }
+  if (configRecord.magic != CONFIG_MAGIC || configRecord.version != version || crc != (raw[size - 2] | (raw[size - 1] << 8))) {
+    return false;
+  }
+  memmove(raw + offsetof(ConfigRecord, plateModel), raw + offsetof(ConfigRecord, plateModel) - missing,
+          sizeof(ConfigRecord) - offsetof(ConfigRecord, plateModel));
+  return true;
+}
+
+// Find the latest valid journal record & load the saved settings from it. Without a record of the current layout the
+// latest record of an older one is migrated - its journal slot number is kept, the first save then goes to the next slot
+// of the current (larger) layout, which never overlaps the old record. A blank chip or corrupted records leave the compiled
+// defaults in place.
+bool configLoad() {
+  uint8_t version;
+  uint8_t i;
+  bool found = 0;
+
+  for (version = CONFIG_VERSION; version >= CONFIG_VERSION_OLDEST && !found; version--) {
+    for (i = 0; i < CONFIG_SLOTS; i++) {
+      if (configRead(i, version) && (!found || (int16_t)(configRecord.sequence - configSequence) > 0)) {   // Wrap safe compare
+        found = 1;
+        configSlot = i;
+        configSequence = configRecord.sequence;
+      }
+    }
+  }
+  if (!found) {
+    return false;
+  }
+  version++;
+  configRead(configSlot, version);
+  memcpy(parametersReflow, configRecord.reflow, sizeof(configRecord.reflow));
+  for (i = 0; i < 6; i++) {
+    parametersPID[i] = (double)configRecord.pid[i] / 100;
+  }
+  memcpy(parametersProcess, configRecord.process, configProcessCount(version));
+  for (i = 0; i < 5; i++) {
+    plateModel[i] = configRecord.plateModel[i];
+  }
+  return true;
+}
+
+uint8_t eeCrc8(const void *data, uint8_t length) {
+  uint8_t crc = 0xFF;                 // Non-zero seed - an all-zero record does not pass
+  for (uint8_t i = 0; i < length; i++) {
+    crc = _crc8_ccitt_update(crc, ((const uint8_t *)data)[i]);
+  }
+  return crc;
+}
+
+// Read a single profile slot into parametersReflow - false if the slot is unused or corrupted
+bool profileLoad(uint8_t slot) {
+  while (eeWriterBusy()) {          // The staging buffers may still be queued & the writer must not move EEAR under a read
+    eeWriterService();
+  }
+  if (profileIndex.nameId[slot] == PROFILE_EMPTY) {
+    return false;
+  }
+  EEPROM.get(EEPROM_ADDR_PROFILE_RECORDS + profileIndex.record[slot] * sizeof(ProfileSlot), profileSlot);
+  if (profileSlot.crc != eeCrc8(&profileSlot, offsetof(ProfileSlot, crc))) {
+    return false;
+  }
+  memcpy(parametersReflow, profileSlot.reflow, sizeof(profileSlot.reflow));
+  return true;
+}
+
+void profileSaved() {
+  profileWriting = 0;
+  if (profileSaveDone != NULL) {
+    profileSaveDone();
+  }
+}
+
+// Queue the index to the other journal copy - the commit point of a save
+void profileIndexWrite(void (*done)()) {
+  profileIndex.sequence++;
+  profileIndex.crc = eeCrc8(&profileIndex, offsetof(ProfileIndex, crc));
+  profileIndexCopy ^= 1;
+  eeWrite(EEPROM_ADDR_PROFILE_INDEX + profileIndexCopy * sizeof(ProfileIndex), &profileIndex, sizeof(profileIndex), done);
+}
+
+// Write the active profile to the spare record, then the index pointing the slot at it. The record being replaced, and the
+// previous index copy referencing it, stay untouched until the next save.
+void profileSave(void (*done)()) {
+  bool used[PROFILE_RECORDS] = { 0 };
+  uint8_t spare = 0;
+  uint8_t i;
+
+  while (profileWriting) {          // The previous save is still being written from the staging buffers
+    eeWriterService();
+  }
+  for (i = 0; i < PROFILE_SLOTS; i++) {
+    used[profileIndex.record[i]] = 1;
+  }
+  while (used[spare]) {
+    spare++;
+  }
+  memcpy(profileSlot.reflow, parametersReflow, sizeof(profileSlot.reflow));
+  profileSlot.crc = eeCrc8(&profileSlot, offsetof(ProfileSlot, crc));
+  profileIndex.nameId[profileIndex.active] = profileNameId;
+  profileIndex.record[profileIndex.active] = spare;
+  profileWriting = 1;
+  profileSaveDone = done;
+  eeWrite(EEPROM_ADDR_PROFILE_RECORDS + spare * sizeof(ProfileSlot), &profileSlot, sizeof(profileSlot), NULL);
+  profileIndexWrite(profileSaved);
+}
+
+bool profileIndexValid(const ProfileIndex &index) {
+  bool used[PROFILE_RECORDS] = { 0 };
+  uint8_t i;
+
+  if (index.magic != PROFILE_MAGIC || index.active >= PROFILE_SLOTS || index.crc != eeCrc8(&index, offsetof(ProfileIndex, crc))) {
+    return false;
+  }
+  for (i = 0; i < PROFILE_SLOTS; i++) {   // Each slot in its own record
+    if (index.record[i] >= PROFILE_RECORDS || used[index.record[i]]) {
+      return false;
+    }
+    used[index.record[i]] = 1;
+  }
+  return true;
+}
+
+// Boot - read the index journal & the active slot. A valid pre-journal index is migrated (its records stay where they are),
+// without any the current parameters become the profile in slot 1.
+void profileIndexLoad() {
+  ProfileIndex index;
+  ProfileIndexV1 legacy;
+  bool found = 0;
+  uint8_t i;
+
+  for (i = 0; i < 2; i++) {
+    EEPROM.get(EEPROM_ADDR_PROFILE_INDEX + i * sizeof(ProfileIndex), index);
+    if (profileIndexValid(index) && (!found || (int8_t)(index.sequence - profileIndex.sequence) > 0)) {   // Wrap safe compare
+      found = 1;
+      profileIndex = index;
+      profileIndexCopy = i;
+    }
+  }
+  if (!found) {
+    EEPROM.get(EEPROM_ADDR_PROFILES, legacy);
+    profileIndex.magic = PROFILE_MAGIC;
+    profileIndex.sequence = 0;
+    for (i = 0; i < PROFILE_SLOTS; i++) {
+      profileIndex.record[i] = i;
+    }
+    if (legacy.magic != PROFILE_MAGIC || legacy.active >= PROFILE_SLOTS || legacy.crc != eeCrc8(&legacy, offsetof(ProfileIndexV1, crc))) {
+      profileIndex.active = 0;
+      memset(profileIndex.nameId, PROFILE_EMPTY, sizeof(profileIndex.nameId));
+      profileIndex.nameId[0] = 0;
+      return;
+    }
+    profileIndex.active = legacy.active;
+    memcpy(profileIndex.nameId, legacy.nameId, sizeof(profileIndex.nameId));
+    profileWriting = 1;
+    profileSaveDone = NULL;
+    profileIndexWrite(profileSaved);
+  }
+  profileLoad(profileIndex.active);
+  profileNameId = profileIndex.nameId[profileIndex.active];
+}
+
+// Profile screen selection - switch to a stored profile, or start a new one from the current parameters in an unused slot
+void profileSelect(uint8_t slot) {
+  if (slot == profileIndex.active) {
+    return;
+  }
+  if (profileLoad(slot)) {
+    profileNameId = profileIndex.nameId[slot];
   } else {
-    tempCounter--;
+    profileNameId = 0;
   }
+  profileIndex.active = slot;
+  profileSave(NULL);
+}
 
-  if (selectFlag == 1) {
-    selectCounter += tempCounter;
+// Boot - locate the newest record & count the valid ones (one block read per ring slot)
+void histFind() {
+  RunRecord record;
+  uint8_t i;
+
+  for (i = 0; i < HIST_RECORDS; i++) {
+    EEPROM.get(EEPROM_ADDR_HISTORY + i * sizeof(RunRecord), record);
+    if (record.crc != eeCrc8(&record, offsetof(RunRecord, crc))) {
+      continue;
+    }
+    if (histCount == 0 || (int8_t)(record.sequence - histSequence) >= 0) {   // Wrap safe compare
+      histNext = (i + 1) % HIST_RECORDS;
+      histSequence = record.sequence + 1;
+    }
+    histCount++;
+  }
+}
+
+// Append the record of the run that just ended - at most once per run
+void histAppend(uint8_t fault) {
+  if (historyLogged) {
+    return;
+  }
+  historyLogged = 1;
+  histRecord.sequence = histSequence++;
+  histRecord.slot = profileIndex.active;
+  histRecord.startT1 = min(runStartTemp[0], 127);
+  histRecord.startT2 = min(runStartTemp[1], 127);
+  histRecord.peak = constrain(max(runPeak1, runPeak2), 0, 511);
+  histRecord.maxDelta = min(runMaxDelta, 63);
+  histRecord.tal = runTAL;
+  histRecord.fault = fault;
+  histRecord.duration = constrain(runningSecondCounter, 0, 2047);
+  histRecord.coolMax = constrain(coolRateMax * 10 + 0.5, 0, 255);
+  if (batchMode == 1) {
+    // A cycle ended by a fault / STOP never passes - incl. one already graded at the end of REFLOW, stopped in COOLING
+    histRecord.batch = (batchCyclePass && fault == HIST_OK) ? HIST_BATCH_PASS : HIST_BATCH_FAIL;
   } else {
-    if ((tempCounter > 0) && (menuCounter < selectIndexMax)) {
-      menuCounter++;
-    } else if ((tempCounter < 0) && (menuCounter > 1)) {
-      menuCounter--;
+    histRecord.batch = HIST_SINGLE;
+  }
+  histRecord.crc = eeCrc8(&histRecord, offsetof(RunRecord, crc));
+  eeWrite(EEPROM_ADDR_HISTORY + histNext * sizeof(RunRecord), &histRecord, sizeof(histRecord), NULL);
+  histNext = (histNext + 1) % HIST_RECORDS;
+  if (histCount < HIST_RECORDS) {
+    histCount++;
+  }
+  histShownIndex = 0;               // Record numbers shifted - reload the history screen
+}
+
+// Read record n (1 = newest) - false if there is no such record
+bool histLoad(uint8_t n, RunRecord &record) {
+  if (n == 0 || n > histCount) {
+    return false;
+  }
+  while (eeWriterBusy()) {          // A record may still be being written
+    eeWriterService();
+  }
+  EEPROM.get(EEPROM_ADDR_HISTORY + ((histNext + HIST_RECORDS - n) % HIST_RECORDS) * sizeof(RunRecord), record);
+  return record.crc == eeCrc8(&record, offsetof(RunRecord, crc));
+}
+
+// Print the history as CSV, oldest record first
+void histDump() {
+  RunRecord record;
+  uint8_t n;
+
+  uart.println(F("run,slot,start1,start2,peak,tal,maxdelta,fault,duration,batch,coolmax"));
+  for (n = histCount; n > 0; n--) {
+    if (!histLoad(n, record)) {
+      continue;
     }
+    uart.print(histCount - n + 1);
+    uart.print(',');
+    uart.print(record.slot + 1);
+    uart.print(',');
+    uart.print(record.startT1);
+    uart.print(',');
+    uart.print(record.startT2);
+    uart.print(',');
+    uart.print(record.peak);
+    uart.print(',');
+    uart.print(record.tal);
+    uart.print(',');
+    uart.print(record.maxDelta);
+    uart.print(',');
+    uart.print(record.fault);
+    uart.print(',');
+    uart.print(record.duration);
+    uart.print(',');
+    uart.print(record.batch);
+    uart.print(',');
+    uart.print(record.coolMax / 10);
+    uart.print('.');
+    uart.println(record.coolMax % 10);
   }
-  tempCounter = 0;
 }
 
 // -----------------------------------------------------------
-// EEPROM Read / Write handling routines
+// Iterative Learning Control (run-to-run feedforward)
+// -----------------------------------------------------------
+uint8_t ilcProfileSignature() {
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < 7; i++) {
+    crc = _crc8_ccitt_update(crc, parametersReflow[i]);
+  }
+  return crc;
+}
+
+void ilcLoad() {
+  uint8_t i;
+  while (eeWriterBusy()) {        // The previous run's record may still be being written
+    eeWriterService();
+  }
+  // Discard the stored vector if it was learned for a different reflow profile (or the EEPROM was never written)
+  if (EEPROM.read(EEPROM_ADDR_ILC) != ilcProfileSignature() || EEPROM.read(EEPROM_ADDR_ILC + 1) == 0xFF) {
+    memset(ilcCorrection, 0, sizeof(ilcCorrection));
+    ilcIteration = 0;
+    return;
+  }
+  ilcIteration = EEPROM.read(EEPROM_ADDR_ILC + 1);
+  for (i = 0; i < 2 * ILC_BINS; i++) {
+    ((uint8_t *)ilcCorrection)[i] = EEPROM.read(EEPROM_ADDR_ILC + 2 + i);
+  }
+}
+
+void ilcSave() {
+  ilcHeader[0] = ilcProfileSignature();
+  ilcHeader[1] = ilcIteration;
+  eeWrite(EEPROM_ADDR_ILC, ilcHeader, 2, NULL);
+  eeWrite(EEPROM_ADDR_ILC + 2, ilcCorrection, sizeof(ilcCorrection), NULL);
+}
+
+// Clear the per-run error accumulators at the start of a reflow run
+void ilcStartRun() {
+  ilcLoad();
+  memset(ilcErrorSum, 0, sizeof(ilcErrorSum));
+  memset(ilcSampleCount, 0, sizeof(ilcSampleCount));
+  ilcFeedforward[0] = 0;
+  ilcFeedforward[1] = 0;
+  trackingErrSqSum = 0.0;
+  trackingSamples = 0;
+  trackingRMS = 0.0;
+}
+
+// Called once per second while the profile is active (RAMP -> REFLOW): accumulate tracking error and update feedforward
+void ilcSample() {
+  uint16_t duration = parametersReflow[5] + parametersReflow[6];   // t3 + Reflow Hold
+  uint16_t binPos;
+  uint8_t bin;
+  uint8_t p;
+  int16_t err;
+  double e1 = pid_Setpoint - steinhart1;
+  double e2 = pid_Setpoint - steinhart2;
+
+  trackingErrSqSum += e1 * e1 + e2 * e2;
+  trackingSamples += 2;
+  trackingRMS = sqrt(trackingErrSqSum / trackingSamples);
+
+  if (duration == 0) {
+    return;
+  }
+  binPos = ((uint32_t)runningSecondCounter * ILC_BINS * 16) / duration;   // Bin position, 4 fractional bits
+  bin = binPos >> 4;
+  if (bin >= ILC_BINS) {
+    bin = ILC_BINS - 1;
+  }
+
+  if (ilcSampleCount[bin] < 255) {
+    for (p = 0; p < 2; p++) {
+      err = (int16_t)constrain((p == 0 ? e1 : e2) * 10.0, -500.0, 500.0);   // 0.1 deg C, clamp to keep the bin sum in range
+      ilcErrorSum[p][bin] += err;
+    }
+    ilcSampleCount[bin]++;
+  }
+
+  // Linearly interpolate the feedforward between bins
+  for (p = 0; p < 2; p++) {
+    if (parametersProcess[0] == 1 && bin < ILC_BINS - 1) {
+      ilcFeedforward[p] = ilcCorrection[p][bin] + (((int16_t)ilcCorrection[p][bin + 1] - ilcCorrection[p][bin]) * (binPos & 0x0F)) / 16;
+    } else if (parametersProcess[0] == 1) {
+      ilcFeedforward[p] = ilcCorrection[p][bin];
+    } else {
+      ilcFeedforward[p] = 0;
+    }
+  }
+}
+
+// Called once when a reflow run completes: refine the correction vector from the mean error observed in each bin
+void ilcUpdate() {
+  int16_t raw[ILC_BINS];
+  int16_t filtered;
+  uint8_t p, j, k;
+
+  ilcFeedforward[0] = 0;
+  ilcFeedforward[1] = 0;
+
+  if (parametersProcess[0] != 1 || thermistor1Fail || thermistor2Fail) {   // Never learn from a run with a sensor fault
+    return;
+  }
+
+  for (p = 0; p < 2; p++) {
+    for (j = 0; j < ILC_BINS; j++) {
+      // Use the error one bin ahead - the plates lag the heater output, so the correction must act before the error appears
+      k = (j < ILC_BINS - 1) ? j + 1 : j;
+      raw[j] = ilcCorrection[p][j];
+      if (ilcSampleCount[k] > 0) {
+        raw[j] += ((int32_t)ILC_GAIN * (ilcErrorSum[p][k] / ilcSampleCount[k])) / 10;
+      }
+    }
+    // 3-tap [1 2 1] / 4 Q-filter - smooths the update so bin-to-bin noise is not learned
+    for (j = 0; j < ILC_BINS; j++) {
+      filtered = (raw[j > 0 ? j - 1 : j] + 2 * raw[j] + raw[j < ILC_BINS - 1 ? j + 1 : j]) / 4;
+      ilcCorrection[p][j] = constrain(filtered, -ILC_LIMIT, ILC_LIMIT);
+    }
+  }
+
+  if (ilcIteration < 254) {
+    ilcIteration++;
+  }
+  ilcSave();
+}
+
+// -----------------------------------------------------------
+// Run Checkpoint & Resume
+// -----------------------------------------------------------
+void cpWrite(uint8_t state);
+
+// Checkpoint write completion - issue the one requested in the meantime
+void cpWritten() {
+  cpWriting = 0;
+  if (cpDeferred) {
+    cpDeferred = 0;
+    cpWrite(cpDeferredState);
+  }
+}
+
+// Write the run progress (state 0 = run ended) to the next checkpoint slot. While the previous checkpoint is still queued
+// only the latest request is kept, and written as soon as the queued one has landed.
+void cpWrite(uint8_t state) {
+  if (cpWriting) {
+    cpDeferred = 1;
+    cpDeferredState = state;
+    return;
+  }
+  cpWriting = 1;
+  cpSlot = (cpSlot + 1) % CP_SLOTS;
+  cpRecord.sequence++;
+  cpRecord.state = state;
+  cpRecord.second = runningSecondCounter;
+  cpRecord.setpoint = constrain(pid_Setpoint, 0, 255);
+  cpRecord.rampOrigin = constrain(initTempSnapshot, 0, 255);
+  cpRecord.signature = ilcProfileSignature();
+  cpRecord.crc = eeCrc8(&cpRecord, offsetof(Checkpoint, crc));
+  eeWrite(EEPROM_ADDR_CHECKPOINT + cpSlot * sizeof(Checkpoint), &cpRecord, sizeof(cpRecord), cpWritten);
+}
+
+// Boot - load the newest valid checkpoint, true if it belongs to an interrupted run
+bool cpFind() {
+  Checkpoint record;
+  uint8_t i;
+  bool found = 0;
+
+  for (i = 0; i < CP_SLOTS; i++) {
+    EEPROM.get(EEPROM_ADDR_CHECKPOINT + i * sizeof(Checkpoint), record);
+    if (record.crc == eeCrc8(&record, offsetof(Checkpoint, crc)) &&
+        (!found || (int8_t)(record.sequence - cpRecord.sequence) > 0)) {   // Wrap safe compare
+      found = 1;
+      cpSlot = i;
+      cpRecord = record;
+    }
+  }
+  if (!found) {
+    cpRecord.sequence = 0;
+    cpRecord.state = 0;
+  }
+  return cpRecord.state != 0;
+}
+
+// An interrupted run can be resumed if it was still heating, the same profile is loaded and the plates have not cooled
+// for longer than CP_MAX_GAP (power-off time estimated from the drop below the setpoint & the passive cooling rate)
+bool cpResumable() {
+  double drop = cpRecord.setpoint - min(steinhart1, steinhart2);
+  return cpRecord.state >= 1 && cpRecord.state <= 4 && cpRecord.signature == ilcProfileSignature()
+         && thermistor1Fail == 0 && thermistor2Fail == 0 && drop * 100 / plateModel[4] <= CP_MAX_GAP;
+}
+
+// -----------------------------------------------------------
+// Batch Production Mode
+// -----------------------------------------------------------
+void batchStart() {
+  batchCycle = 1;
+  batchPassCount = 0;
+  batchFailCount = 0;
+  batchGateOpen = 0;
+}
+
+// Called once when a batch cycle completes: grade the cycle from the run metrics
+void batchRecordCycle() {
+  bool pass = (thermistor1Fail == 0 && thermistor2Fail == 0)
+           && fabs(runPeak1 - parametersReflow[4]) <= BATCH_PEAK_TOL
+           && fabs(runPeak2 - parametersReflow[4]) <= BATCH_PEAK_TOL
+           && trackingRMS <= BATCH_RMS_LIMIT;
+  batchCyclePass = pass;
+  if (pass) {
+    batchPassCount++;
+  } else {
+    batchFailCount++;
+  }
+  batchGateOpen = 0;
+}
+
+// Batch is waiting between cycles (last cycle COMPLETE, more cycles remaining)
+bool batchWaiting() {
+  return batchMode == 1 && runningState == 6 && batchCycle < parametersProcess[2];
+}
+
+void batchNextCycle() {
+  batchCycle++;
+  batchGateOpen = 0;
+  batchNextRequest = 1;
+  menuCounter = 1;
+}
+
+// -----------------------------------------------------------
+// Plate Heating Model & Profile Feasibility Pre-Check
+// -----------------------------------------------------------
+// Max heating rate (C/s) of a plate at full power at the given temperature
+double plateMaxRate(uint8_t plate, double temp) {
+  double w = (temp - MODEL_T_LOW) / (MODEL_T_HIGH - MODEL_T_LOW);
+  double rate;
+  if (w < 0) {
+    w = 0;
+  }
+  rate = (plateModel[2 * plate] + (plateModel[2 * plate + 1] - plateModel[2 * plate]) * w) / 100.0;
+  if (rate < 0) {
+    rate = 0;
+  }
+  return rate;
+}
+
+// Profile timeline second at which a run starting at the given plate temperature joins the RAMP line (pre-warmed plates)
+int rampStartSecond(double temp) {
+  if (temp <= RAMP_REF_TEMP) {
+    return 0;
+  }
+  if (temp >= parametersReflow[0]) {
+    return parametersReflow[1];
+  }
+  return (temp - RAMP_REF_TEMP) * parametersReflow[1] / (parametersReflow[0] - RAMP_REF_TEMP);
+}
+
+// Setpoint of the running profile at a running second counter value - RAMP -> REFLOW, then the COOLING setpoint once the
+// run has reached COOLING (0 for passive cooling)
+double profileSetpoint(int second) {
+  double sp;
+
+  if (second < parametersReflow[1]) {          // RAMP
+    return ((double)parametersReflow[0] - initTempSnapshot) / (double)parametersReflow[1] * (double)second + initTempSnapshot;
+  }
+  if (second < parametersReflow[3]) {          // SOAK
+    return ((double)parametersReflow[2] - (double)parametersReflow[0]) / ((double)parametersReflow[3] - (double)parametersReflow[1]) * ((double)second - (double)parametersReflow[1]) + (double)parametersReflow[0];
+  }
+  if (second < parametersReflow[5]) {          // REFLOW RAMP
+    return ((double)parametersReflow[4] - (double)parametersReflow[2]) / ((double)parametersReflow[5] - (double)parametersReflow[3]) * ((double)second - (double)parametersReflow[3]) + (double)parametersReflow[2];
+  }
+  if (second < parametersReflow[5] + parametersReflow[6] || runningState < 5) {   // REFLOW
+    return (double)parametersReflow[4];
+  }
+  if (parametersProcess[5] == 0) {             // COOLING - passive
+    return 0.0;
+  }
+  sp = (double)parametersReflow[4] - (parametersProcess[5] / 10.0) * (double)(second - coolStartSecond);
+  return max(sp, 0.0);
+}
+
+// Called once per second while heating (RAMP -> REFLOW): refine the model from samples where a plate was at full power
+void modelSample() {
+  double temp[2] = { steinhart1, steinhart2 };
+  double rate, w, err;
+  uint8_t p;
+
+  for (p = 0; p < 2; p++) {
+    if (!(plateUnsaturated & (1 << p)) && modelPrevTemp[p] > 0) {
+      rate = temp[p] - modelPrevTemp[p];
+      w = constrain((temp[p] - MODEL_T_LOW) / (MODEL_T_HIGH - MODEL_T_LOW), 0.0, 1.0);
+      err = (rate - plateMaxRate(p, temp[p])) * 100.0;   // LMS update of both reference points, split by interpolation weight
+      plateModel[2 * p] += (int)((1.0 - w) * err) / MODEL_LMS_DIV;
+      plateModel[2 * p + 1] += (int)(w * err) / MODEL_LMS_DIV;
+      plateModel[2 * p] = constrain(plateModel[2 * p], 1, 1000);
+      plateModel[2 * p + 1] = constrain(plateModel[2 * p + 1], 1, 1000);
+      plateModelChanged = 1;
+    }
+    modelPrevTemp[p] = temp[p];
+  }
+  plateUnsaturated = 0;
+}
+
+// Called once when passive cooling completes: refine the passive cooling rate from the measured average rate
+void modelCoolSample(double rate) {
+  if (rate > 0) {
+    plateModel[4] += (int)(rate * 100.0 - plateModel[4]) / MODEL_LMS_DIV;
+    plateModel[4] = constrain(plateModel[4], 1, 1000);
+    plateModelChanged = 1;
+  }
+}
+
+void modelSave() {
+  if (plateModelChanged) {
+    configSave(NULL);
+    plateModelChanged = 0;
+  }
+}
+
+// Pre-start analysis for the confirm dialog: flag heating segments the plates cannot follow from the current temperature
+// and predict the total run time. A handful of float operations - evaluated once when the dialog is entered.
+void profileAnalyze() {
+  double startTemp = (steinhart1 + steinhart2) / 2;
+  int t0 = rampStartSecond(startTemp);
+  double segTemp[4] = { startTemp, (double)parametersReflow[0], (double)parametersReflow[2], (double)parametersReflow[4] };
+  int segTime[4] = { t0, parametersReflow[1], parametersReflow[3], parametersReflow[5] };
+  double dT, maxRate, coolRate;
+  int dt;
+  uint8_t i;
+
+  if (startTemp > RAMP_REF_TEMP && startTemp < parametersReflow[0]) {
+    segTemp[0] = startTemp;
+  } else if (startTemp >= parametersReflow[0]) {
+    segTemp[0] = parametersReflow[0];
+  }
+
+  infeasibleSegments = 0;
+  for (i = 0; i < 3; i++) {
+    dT = segTemp[i + 1] - segTemp[i];
+    dt = segTime[i + 1] - segTime[i];
+    maxRate = min(plateMaxRate(0, segTemp[i + 1]), plateMaxRate(1, segTemp[i + 1]));   // Worst case - rate is lowest at the segment end
+    if (dT > 0 && (dt <= 0 || dT / dt > maxRate)) {
+      infeasibleSegments |= (1 << i);
+    }
+  }
+  if (min(plateMaxRate(0, parametersReflow[4]), plateMaxRate(1, parametersReflow[4])) <= 0) {   // REFLOW - T3 cannot be held
+    infeasibleSegments |= (1 << 3);
+  }
+
+  // Run time = remaining profile timeline + cooling to Safe To Remove (the plates cannot cool faster than passive)
+  predictedRunTime = parametersReflow[5] + parametersReflow[6] - t0;
+  if (parametersReflow[4] > parametersProcess[6]) {
+    coolRate = plateModel[4] / 100.0;
+    if (parametersProcess[5] > 0 && parametersProcess[5] / 10.0 < coolRate) {
+      coolRate = parametersProcess[5] / 10.0;
+    }
+    predictedRunTime += (parametersReflow[4] - parametersProcess[6]) / coolRate;
+  }
+}
+
+// -----------------------------------------------------------
+// Fixed-Point Number Formatting
+// -----------------------------------------------------------
+// Integer-only replacement for Print::printFloat (repeated float multiply / subtract per digit). The value is scaled &
+// rounded once, then split into digits with integer division, right aligned in a fixed width so live values do not
+// shift on the display.
+#define FMT_BUF_SIZE 14
+const long fmtScale[4] PROGMEM = { 1, 10, 100, 1000 };
+
+// Format 'scaled' (value in units of 10^-decimals) right aligned in 'width' characters (0 = no padding) - returns buf
+char *formatFixed(char *buf, long scaled, uint8_t decimals, uint8_t width) {
+  char digits[FMT_BUF_SIZE];
+  unsigned long v = scaled;
+  uint8_t n = 0;
+  uint8_t len = 0;
+  uint8_t i;
+
+  if (scaled < 0) {
+    v = -scaled;
+  }
+  for (i = 0; i < decimals; i++) {    // Digits are produced least significant first
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  }
+  if (decimals > 0) {
+    digits[n++] = '.';
+  }
+  do {
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  } while (v > 0);
+  if (scaled < 0) {
+    digits[n++] = '-';
+  }
+  while (len + n < width && len < FMT_BUF_SIZE - 1 - n) {
+    buf[len++] = ' ';
+  }
+  while (n > 0) {
+    buf[len++] = digits[--n];
+  }
+  buf[len] = 0;
+  return buf;
+}
+
+// Print a double with 'decimals' (0 - 3) fixed decimals, right aligned in 'width' characters (0 = no padding)
+void printFixed(Print &out, double value, uint8_t decimals, uint8_t width) {
+  char buf[FMT_BUF_SIZE];
+  long scaled;
+
+  if (value < 0) {
+    scaled = value * (long)pgm_read_dword(&fmtScale[decimals]) - 0.5;
+  } else {
+    scaled = value * (long)pgm_read_dword(&fmtScale[decimals]) + 0.5;
+  }
+  out.print(formatFixed(buf, scaled, decimals, width));
+}
+
+// -----------------------------------------------------------
+// Run Trend Graph
+// -----------------------------------------------------------
+// Clear the ring buffer at the start of a reflow run and pick the sample interval that fits the predicted run in the graph
+void graphStart() {
+  graphHead = 0;
+  graphCount = 0;
+  graphDrawn = 0;
+  graphInterval = predictedRunTime / GRAPH_SAMPLES + 1;
+  graphLastSecond = runningSecondCounter - graphInterval;   // Take the first sample right away
+  graphFirstSecond = runningSecondCounter;
+}
+
+uint8_t graphQuantize(double temp) {
+  return constrain(temp + 0.5, 0.0, 255.0);
+}
+
+// Called once per second while the run is in progress (RAMP -> COOLING)
+void graphSample() {
+  uint8_t i;
+
+  if (runningSecondCounter - graphLastSecond < graphInterval) {
+    return;
+  }
+  graphLastSecond = runningSecondCounter;
+  if (graphCount < GRAPH_SAMPLES) {
+    i = (graphHead + graphCount) % GRAPH_SAMPLES;
+    graphCount++;
+  } else {                          // Longer run than predicted - overwrite the oldest sample & scroll the graph
+    i = graphHead;
+    graphHead = (graphHead + 1) % GRAPH_SAMPLES;
+    graphFirstSecond += graphInterval;
+    graphDrawn = 0;
+  }
+  graphData[0][i] = graphQuantize(steinhart1);
+  graphData[1][i] = graphQuantize(steinhart2);
+}
+
+// Pixel row of a temperature in the plot area
+uint8_t graphY(uint8_t temp) {
+  int span = parametersReflow[4] + GRAPH_HEADROOM - GRAPH_T_MIN;
+  int y;
+  if (span < GRAPH_HEADROOM) {
+    span = GRAPH_HEADROOM;
+  }
+  y = ((int)temp - GRAPH_T_MIN) * (63 - GRAPH_TOP_ROW * 8) / span;
+  return 63 - constrain(y, 0, 63 - GRAPH_TOP_ROW * 8);
+}
+
+// Draw graph column x (sample x, oldest first): plate temperatures solid & joined to the previous sample, SP dotted,
+// T3 reference line every 4th column
+void graphDrawColumn(uint8_t x) {
+  uint8_t i = (graphHead + x) % GRAPH_SAMPLES;
+  uint8_t prev = i;
+  uint8_t ch, y0, y1;
+
+  if (x > 0) {
+    prev = (graphHead + x - 1) % GRAPH_SAMPLES;
+  }
+  for (ch = 0; ch < 2; ch++) {
+    y0 = graphY(graphData[ch][prev]);
+    y1 = graphY(graphData[ch][i]);
+    u8g2.drawVLine(x, min(y0, y1), abs((int)y1 - y0) + 1);
+  }
+  if ((x & 1) == 0) {
+    u8g2.drawPixel(x, graphY(graphQuantize(profileSetpoint(graphFirstSecond + x * graphInterval))));
+  }
+  if ((x & 3) == 0) {
+    u8g2.drawPixel(x, graphY(parametersReflow[4]));
+  }
+}
+
+void graphDrawHeader() {
+  u8g2.setFont(u8g2_font_5x7_tr);
+  u8g2.setCursor(0, 6);
+  switch (runningState) {
+    case 1: u8g2.print(F("RAMP")); break;
+    case 2: u8g2.print(F("SOAK")); break;
+    case 3: u8g2.print(F("RFLW RAMP")); break;
+    case 4: u8g2.print(F("REFLOW")); break;
+    case 5: u8g2.print(F("COOLING")); break;
+    case 6: u8g2.print(F("COMPLETE")); break;
+  }
+  u8g2.setCursor(80, 6);
+  u8g2.print(runningSecondCounter);
+  u8g2.print(F(" s"));
+  u8g2.setCursor(0, 14);
+  u8g2.print(F("T1:"));
+  printFixed(u8g2, T1Disp, 0, 3);
+  u8g2.setCursor(40, 14);
+  u8g2.print(F("T2:"));
+  printFixed(u8g2, T2Disp, 0, 3);
+  u8g2.setCursor(80, 14);
+  u8g2.print(F("SP:"));
+  printFixed(u8g2, pid_Setpoint, 0, 3);
+}
+
+// -----------------------------------------------------------
+// Menu Descriptor Tables
 // -----------------------------------------------------------
-void writeUInt8TArrayIntoEEPROM(int address, uint8_t numbers[], int arraySize) {
-  int addressIndex = address;
-  for (int i = 0; i < arraySize; i++) 
-  {
-    EEPROM.update(addressIndex, numbers[i]);   // Does not need to be bit shifted as the uint8_t data type takes only 1 byte
-    addressIndex ++;
-    delay(10); // delay for EEPROM
+// Every screen is described by a PROGMEM table of its selectable items: position, label, the parameter an item edits with
+// its step & limits, or the screen / action it leads to. One generic navigator & renderer work from the tables, only the
+// screen specific content (confirm text, running values, ...) is drawn by hand.
+#define MI_LINK 0           // Select: go to the target screen
+#define MI_ACTION 1         // Select: run the target action (menuAction)
+#define MI_UINT8 2          // Edit a uint8_t parameter
+#define MI_ONOFF 3          // Edit a uint8_t parameter, shown as ON / OFF
+#define MI_UINT8_OFF 4      // Edit a uint8_t parameter, shown as OFF when 0
+#define MI_TENTHS_OFF 5     // Edit a uint8_t parameter in 0.1 units, shown as OFF when 0
+#define MI_DOUBLE 6         // Edit a double parameter in 0.01 units
+#define MI_PROFILE 7        // Select: switch to the profile slot in minVal (profileSelect)
+#define MI_NAME 8           // Edit a uint8_t profile name id, shown as the name
+
+#define ACT_START_REFLOW 0
+#define ACT_START_CONST 1
+#define ACT_START_BATCH 2
+#define ACT_CONFIRM_NO 3
+#define ACT_CONFIRM_YES 4
+#define ACT_STOP 5
+#define ACT_BATCH_NEXT 6
+#define ACT_HIST_DUMP 7
+#define ACT_RESUME 8
+#define ACT_RESUME_ABORT 9
+
+#define MENU_CHAR_W 6       // Menu font character width (pixels)
+#define TEXT_ASCENT 9       // Pixel rows above / below the baseline a line of menu text (incl. edit frame) can touch
+#define TEXT_DESCENT 2
+#define ITEMS(a) a, sizeof(a) / sizeof(a[0])
+
+struct MenuItem {
+  uint8_t type;
+  uint8_t x, y;             // Cursor position - the label is drawn one character to the right (NULL label = hidden item)
+  const char *label;        // PROGMEM
+  const char *unit;         // PROGMEM, NULL = none
+  void *param;              // Edited parameter
+  uint8_t minVal, maxVal;   // Edit limits
+  uint8_t step;             // Edit step per encoder count (parameter units, 0.01 for MI_DOUBLE)
+  uint8_t frameW;           // Edit frame width (pixels)
+  uint8_t target;           // Target screen (MI_LINK) / action (MI_ACTION)
+};
+
+struct MenuScreen {
+  const char *title;        // PROGMEM header, NULL = screen draws its own header
+  const MenuItem *items;    // PROGMEM
+  uint8_t itemCount;
+};
+
+const char ttlMain[] PROGMEM = "   MAIN MENU    ";       // Tile mode screens - 16 columns
+const char ttlConfig[] PROGMEM = "  CONFIG MENU   ";
+const char ttlReflow[] PROGMEM = "   Reflow  Profile    ";
+const char ttlPID[] PROGMEM = "      PID Tuning     ";
+const char ttlProcess[] PROGMEM = "   Process Options   ";
+const char ttlProfiles[] PROGMEM = "      Profiles       ";
+const char ttlHistory[] PROGMEM = "     Run History     ";
+const char ttlResume[] PROGMEM = "   Run Interrupted   ";
+
+const char lblStartReflow[] PROGMEM = "Start Reflow";
+const char lblStartConst[] PROGMEM = "Start Const Tmp";
+const char lblStartBatch[] PROGMEM = "Start Batch";
+const char lblConfig[] PROGMEM = "Configuration";
+const char lblProfiles[] PROGMEM = "Profiles";
+const char lblSlot[] PROGMEM = "";
+const char lblName[] PROGMEM = "Name: ";
+const char lblNo[] PROGMEM = "NO";
+const char lblYes[] PROGMEM = "YES";
+const char lblReflowProfile[] PROGMEM = "Reflow Profile";
+const char lblPIDParameters[] PROGMEM = "PID Parameters";
+const char lblProcessOptions[] PROGMEM = "Process Options";
+const char lblSaveConfig[] PROGMEM = "Save Config";
+const char lblRunHistory[] PROGMEM = "Run History";
+const char lblRun[] PROGMEM = "Run: ";
+const char lblDump[] PROGMEM = "DUMP";
+const char lblResume[] PROGMEM = "RESUME";
+const char lblAbort[] PROGMEM = "ABORT";
+const char lblBack[] PROGMEM = "BACK";
+const char lblT1[] PROGMEM = "T1: ";
+const char lblt1[] PROGMEM = "t1: ";
+const char lblT2[] PROGMEM = "T2: ";
+const char lblt2[] PROGMEM = "t2: ";
+const char lblT3[] PROGMEM = "T3: ";
+const char lblt3[] PROGMEM = "t3: ";
+const char lblReflowHold[] PROGMEM = "Reflow Hold: ";
+const char lblKp1[] PROGMEM = "Kp1: ";
+const char lblKi1[] PROGMEM = "Ki1: ";
+const char lblKd1[] PROGMEM = "Kd1: ";
+const char lblKp2[] PROGMEM = "Kp2: ";
+const char lblKi2[] PROGMEM = "Ki2: ";
+const char lblKd2[] PROGMEM = "Kd2: ";
+const char lblLearn[] PROGMEM = "Learn: ";
+const char lblStandby[] PROGMEM = "Stby:";
+const char lblBatch[] PROGMEM = "Batch: ";
+const char lblReEntry[] PROGMEM = "ReEn:";
+const char lblAuto[] PROGMEM = "Auto: ";
+const char lblCool[] PROGMEM = "Cool:";
+const char lblSafe[] PROGMEM = "Safe: ";
+const char lblTelemetry[] PROGMEM = "Tlm: ";
+const char lblLiquidus[] PROGMEM = "Liq: ";
+const char lblSP[] PROGMEM = "SP: ";
+const char lblStop[] PROGMEM = "STOP";
+const char lblNext[] PROGMEM = "NEXT";
+const char lblGraph[] PROGMEM = "GRAPH";
+const char unitC[] PROGMEM = " C";
+const char unitS[] PROGMEM = " s";
+const char unitCShort[] PROGMEM = "C";
+
+#define PROFILE_NAMES 12
+const char profileNames[PROFILE_NAMES][8] PROGMEM = {
+  "Custom", "SnBiAg", "SnBi", "SAC305", "SAC0307", "Sn63Pb", "Sn62Pb", "LowTemp", "BoardA", "BoardB", "BoardC", "BoardD",
+};
+
+const MenuItem mainItems[] PROGMEM = {
+  { MI_ACTION, 0, 19, lblStartReflow, NULL, NULL, 0, 0, 0, 0, ACT_START_REFLOW },
+  { MI_ACTION, 0, 27, lblStartConst, NULL, NULL, 0, 0, 0, 0, ACT_START_CONST },
+  { MI_ACTION, 0, 35, lblStartBatch, NULL, NULL, 0, 0, 0, 0, ACT_START_BATCH },
+  { MI_LINK, 0, 43, lblProfiles, NULL, NULL, 0, 0, 0, 0, 7 },
+  { MI_LINK, 0, 51, lblConfig, NULL, NULL, 0, 0, 0, 0, 2 },
+};
+
+const MenuItem confirmItems[] PROGMEM = {
+  { MI_ACTION, 29, 45, lblNo, NULL, NULL, 0, 0, 0, 0, ACT_CONFIRM_NO },
+  { MI_ACTION, 69, 45, lblYes, NULL, NULL, 0, 0, 0, 0, ACT_CONFIRM_YES },
+};
+
+const MenuItem configItems[] PROGMEM = {
+  { MI_LINK, 0, 19, lblReflowProfile, NULL, NULL, 0, 0, 0, 0, 3 },
+  { MI_LINK, 0, 27, lblPIDParameters, NULL, NULL, 0, 0, 0, 0, 4 },
+  { MI_LINK, 0, 35, lblProcessOptions, NULL, NULL, 0, 0, 0, 0, 6 },
+  { MI_LINK, 0, 43, lblSaveConfig, NULL, NULL, 0, 0, 0, 0, 5 },
+  { MI_LINK, 0, 51, lblRunHistory, NULL, NULL, 0, 0, 0, 0, 8 },
+  { MI_LINK, 0, 64, lblBack, NULL, NULL, 0, 0, 0, 0, 0 },
+};
+
+const MenuItem reflowItems[] PROGMEM = {
+  { MI_UINT8, 0, 19, lblT1, unitC, &parametersReflow[0], 0, 255, 1, 34, 0 },
+  { MI_UINT8, 66, 19, lblt1, unitS, &parametersReflow[1], 0, 255, 1, 34, 0 },
+  { MI_UINT8, 0, 29, lblT2, unitC, &parametersReflow[2], 0, 255, 1, 34, 0 },
+  { MI_UINT8, 66, 29, lblt2, unitS, &parametersReflow[3], 0, 255, 1, 34, 0 },
+  { MI_UINT8, 0, 39, lblT3, unitC, &parametersReflow[4], 0, 255, 1, 34, 0 },
+  { MI_UINT8, 66, 39, lblt3, unitS, &parametersReflow[5], 0, 255, 1, 34, 0 },
+  { MI_UINT8, 0, 49, lblReflowHold, unitS, &parametersReflow[6], 0, 255, 1, 34, 0 },
+  { MI_LINK, 0, 64, lblBack, NULL, NULL, 0, 0, 0, 0, 2 },
+};
+
+const MenuItem pidItems[] PROGMEM = {
+  { MI_DOUBLE, 0, 19, lblKp1, NULL, &parametersPID[0], 0, 255, 1, 28, 0 },
+  { MI_DOUBLE, 0, 29, lblKi1, NULL, &parametersPID[1], 0, 255, 1, 28, 0 },
+  { MI_DOUBLE, 0, 39, lblKd1, NULL, &parametersPID[2], 0, 255, 1, 28, 0 },
+  { MI_DOUBLE, 66, 19, lblKp2, NULL, &parametersPID[3], 0, 255, 1, 28, 0 },
+  { MI_DOUBLE, 66, 29, lblKi2, NULL, &parametersPID[4], 0, 255, 1, 28, 0 },
+  { MI_DOUBLE, 66, 39, lblKd2, NULL, &parametersPID[5], 0, 255, 1, 28, 0 },
+  { MI_LINK, 0, 64, lblBack, NULL, NULL, 0, 0, 0, 0, 2 },
+};
+
+const MenuItem processItems[] PROGMEM = {
+  { MI_ONOFF, 0, 19, lblLearn, NULL, &parametersProcess[0], 0, 1, 1, 22, 0 },
+  { MI_UINT8_OFF, 66, 19, lblStandby, unitCShort, &parametersProcess[1], 0, 150, 1, 28, 0 },
+  { MI_UINT8, 0, 29, lblBatch, NULL, &parametersProcess[2], 1, 32, 1, 22, 0 },
+  { MI_UINT8, 66, 29, lblReEntry, unitCShort, &parametersProcess[3], 30, 150, 1, 28, 0 },
+  { MI_ONOFF, 0, 39, lblAuto, NULL, &parametersProcess[4], 0, 1, 1, 22, 0 },
+  { MI_TENTHS_OFF, 66, 39, lblCool, NULL, &parametersProcess[5], 0, 50, 1, 28, 0 },
+  { MI_UINT8, 0, 49, lblSafe, unitCShort, &parametersProcess[6], 30, 150, 1, 28, 0 },
+  { MI_TENTHS_OFF, 66, 49, lblTelemetry, NULL, &parametersProcess[7], 0, 50, 2, 28, 0 },
+  { MI_UINT8, 66, 64, lblLiquidus, unitCShort, &parametersProcess[8], 100, 250, 1, 28, 0 },
+  { MI_LINK, 0, 64, lblBack, NULL, NULL, 0, 0, 0, 0, 2 },
+};
+
+const MenuItem profileItems[] PROGMEM = {
+  { MI_PROFILE, 0, 19, lblSlot, NULL, NULL, 0, 0, 0, 0, 0 },
+  { MI_PROFILE, 66, 19, lblSlot, NULL, NULL, 1, 0, 0, 0, 0 },
+  { MI_PROFILE, 0, 29, lblSlot, NULL, NULL, 2, 0, 0, 0, 0 },
+  { MI_PROFILE, 66, 29, lblSlot, NULL, NULL, 3, 0, 0, 0, 0 },
+  { MI_PROFILE, 0, 39, lblSlot, NULL, NULL, 4, 0, 0, 0, 0 },
+  { MI_PROFILE, 66, 39, lblSlot, NULL, NULL, 5, 0, 0, 0, 0 },
+  { MI_NAME, 0, 51, lblName, NULL, &profileNameId, 0, PROFILE_NAMES - 1, 1, 46, 0 },
+  { MI_LINK, 0, 64, lblBack, NULL, NULL, 0, 0, 0, 0, 0 },
+};
+
+const MenuItem historyItems[] PROGMEM = {
+  { MI_UINT8, 0, 19, lblRun, NULL, &histView, 1, HIST_RECORDS, 1, 22, 0 },
+  { MI_ACTION, 0, 64, lblDump, NULL, NULL, 0, 0, 0, 0, ACT_HIST_DUMP },
+  { MI_LINK, 66, 64, lblBack, NULL, NULL, 0, 0, 0, 0, 2 },
+};
+
+const MenuItem resumeItems[] PROGMEM = {
+  { MI_ACTION, 0, 64, lblAbort, NULL, NULL, 0, 0, 0, 0, ACT_RESUME_ABORT },
+  { MI_ACTION, 66, 64, lblResume, NULL, NULL, 0, 0, 0, 0, ACT_RESUME },
+};
+
+const MenuItem graphItems[] PROGMEM = {
+  { MI_LINK, 0, 0, NULL, NULL, NULL, 0, 0, 0, 0, 99 },
+};
+
+const MenuItem constItems[] PROGMEM = {
+  { MI_UINT8, 0, 48, lblSP, unitC, &constTempSP, 0, 255, 1, 34, 0 },
+  { MI_ACTION, 0, 64, lblStop, NULL, NULL, 0, 0, 0, 0, ACT_STOP },
+};
+
+const MenuItem reflowRunItems[] PROGMEM = {
+  { MI_ACTION, 0, 64, lblStop, NULL, NULL, 0, 0, 0, 0, ACT_STOP },
+  { MI_LINK, 66, 64, lblGraph, NULL, NULL, 0, 0, 0, 0, 97 },
+};
+
+const MenuItem batchWaitItems[] PROGMEM = {    // Screen 99 while a batch is waiting between cycles
+  { MI_ACTION, 0, 64, lblNext, NULL, NULL, 0, 0, 0, 0, ACT_BATCH_NEXT },
+  { MI_ACTION, 42, 64, lblStop, NULL, NULL, 0, 0, 0, 0, ACT_STOP },
+  { MI_LINK, 84, 64, lblGraph, NULL, NULL, 0, 0, 0, 0, 97 },
+};
+
+// Indexed by menuIndex - the running screens 97 - 99 follow the idle screens 0 - 9
+const MenuScreen menuScreens[] PROGMEM = {
+  { ttlMain, ITEMS(mainItems) },          // 0) MAIN MENU
+  { NULL, ITEMS(confirmItems) },          // 1) CONFIRM
+  { ttlConfig, ITEMS(configItems) },      // 2) CONFIGURATION MENU
+  { ttlReflow, ITEMS(reflowItems) },      // 3) SET REFLOW PROFILE
+  { ttlPID, ITEMS(pidItems) },            // 4) PID TUNING
+  { NULL, NULL, 0 },                      // 5) SAVE CONFIGURATION
+  { ttlProcess, ITEMS(processItems) },    // 6) PROCESS OPTIONS
+  { ttlProfiles, ITEMS(profileItems) },   // 7) PROFILES
+  { ttlHistory, ITEMS(historyItems) },    // 8) RUN HISTORY
+  { ttlResume, ITEMS(resumeItems) },      // 9) RESUME INTERRUPTED RUN
+  { NULL, ITEMS(graphItems) },            // 97) RUNNING - TREND GRAPH
+  { NULL, ITEMS(constItems) },            // 98) RUNNING - CONSTANT TEMP
+  { NULL, ITEMS(reflowRunItems) },        // 99) RUNNING - REFLOW PROFILE
+};
+
+const MenuScreen *menuScreen(uint8_t index) {
+  if (index >= 97) {
+    index -= 87;
   }
+  return &menuScreens[index];
 }
 
-void writeIntArrayIntoEEPROM(int address, int numbers[], int arraySize) {
-  int addressIndex = address;
-  for (int i = 0; i < arraySize; i++) 
-  {
-    EEPROM.update(addressIndex, numbers[i] >> 8);
-    EEPROM.update(addressIndex + 1, numbers[i] & 0xFF);
-    addressIndex += 2;
-    delay(10); // delay for EEPROM
+// Item table of a screen - returns the number of items
+uint8_t menuItems(uint8_t index, bool waiting, const MenuItem **items) {
+  if (index == 99 && waiting) {
+    *items = batchWaitItems;
+    return sizeof(batchWaitItems) / sizeof(batchWaitItems[0]);
   }
+  *items = (const MenuItem *)pgm_read_ptr(&menuScreen(index)->items);
+  return pgm_read_byte(&menuScreen(index)->itemCount);
 }
 
-void readUInt8TArrayFromEEPROM(int address, uint8_t numbers[], int arraySize) {
-  int addressIndex = address;
-  for (int i = 0; i < arraySize; i++)
-  {
-    numbers[i] = (EEPROM.read(addressIndex));  // Does not need to be bit shifted as the uint8_t data type takes only 1 byte
-    addressIndex ++;
-    delay(10);
+// Copy item 'counter' (1 based, as menuCounter) of a screen from flash - false if the screen has no such item
+bool menuItemLoad(uint8_t index, uint8_t counter, bool waiting, MenuItem *item) {
+  const MenuItem *items;
+  if (counter < 1 || counter > menuItems(index, waiting, &items)) {
+    return false;
   }
+  memcpy_P(item, &items[counter - 1], sizeof(MenuItem));
+  return true;
 }
 
-void readIntArrayFromEEPROM(int address, int numbers[], int arraySize) {
-  int addressIndex = address;
-  for (int i = 0; i < arraySize; i++)
-  {
-    numbers[i] = (EEPROM.read(addressIndex) << 8) + EEPROM.read(addressIndex + 1);
-    addressIndex += 2;
-    delay(10);
+void menuAction(uint8_t action) {
+  switch (action) {
+    case ACT_START_REFLOW:
+      runningMode = 1;
+      batchMode = 0;
+      startConfirm = 1;
+      menuIndex = 1;
+      profileAnalyze();
+      break;
+    case ACT_START_CONST:
+      runningMode = 0;
+      batchMode = 0;
+      startConfirm = 1;
+      menuIndex = 1;
+      break;
+    case ACT_START_BATCH:
+      runningMode = 1;
+      batchMode = 1;
+      startConfirm = 1;
+      menuIndex = 1;
+      profileAnalyze();
+      break;
+    case ACT_CONFIRM_NO:
+      if (startConfirm == 1) {    // If Start Confirm True, profile is NOT running, selecing 'NO' would fall back to main menu
+        running = 0;
+        batchMode = 0;
+        menuIndex = 0;
+        startConfirm = 0;
+      } else {                    // If Start Confirm False, profile IS running, selecing 'NO' would fall back to running screen to continue running
+        running = 1;
+        if (runningMode == 1) {
+          menuIndex = 99;
+        } else {
+          menuIndex = 98;
+        }
+      }
+      break;
+    case ACT_CONFIRM_YES:
+      if (startConfirm == 1) {    // if Start Confirm True, selecting 'Yes' would START running the profile
+        running = 1;
+        if (batchMode == 1) {
+          batchStart();
+        }
+        if (runningMode == 1) {
+          menuIndex = 99;
+        } else {
+          menuIndex = 98;
+        }
+        startConfirm = 0;
+      } else {                    // if Start Confirm False, profile is running. Selecting 'Yes' would STOP running the profile
+        running = 0;
+        batchMode = 0;
+        menuIndex = 0;
+      }
+      break;
+    case ACT_STOP:
+      startConfirm = 0;
+      menuIndex = 1;
+      break;
+    case ACT_BATCH_NEXT:
+      if (batchGateOpen) {        // Single press starts the next cycle once the plates are below the Re-Entry Temp
+        batchNextCycle();
+      }
+      return;
+    case ACT_HIST_DUMP:
+      histDump();
+      return;
+    case ACT_RESUME:
+      cpPending = 0;
+      if (!cpResumable()) {       // Plates cooled too far while the dialog was open
+        cpWrite(0);
+        menuIndex = 0;
+        break;
+      }
+      runningMode = 1;
+      batchMode = 0;
+      running = 1;
+      runningBuffer = 1;          // Skip the run start initialization - continue from the checkpoint instead
+      runningState = cpRecord.state;
+      runningSecondCounter = cpRecord.second;
+      initTempSnapshot = cpRecord.rampOrigin;
+      runPeak1 = 0.0;
+      runPeak2 = 0.0;
+      runStartTemp[0] = constrain(steinhart1, 0, 255);
+      runStartTemp[1] = constrain(steinhart2, 0, 255);
+      runTAL = 0;
+      runMaxDelta = 0;
+      coolRateMax = 0.0;
+      historyLogged = 0;
+      ilcStartRun();
+      profileAnalyze();           // Graph scale - predicted run time, moved from the warm-start entry to the checkpoint
+      predictedRunTime += rampStartSecond((steinhart1 + steinhart2) / 2) - (int)cpRecord.second;
+      graphStart();
+      modelPrevTemp[0] = 0.0;
+      modelPrevTemp[1] = 0.0;
+      plateUnsaturated = 0x03;
+      time_now = millis();
+      menuIndex = 99;
+      break;
+    case ACT_RESUME_ABORT:
+      cpPending = 0;
+      cpWrite(0);
+      menuIndex = 0;
+      break;
+  }
+  menuCounter = 1;
+}
+
+// Long press - abandon a parameter edit without saving it, otherwise back out of the config screens one level
+void menuBack() {
+  if (selectFlag == 1) {
+    selectFlag = 0;
+    noInterrupts();
+    selectCounter = 0;
+    interrupts();
+    wrkInt = 0;
+    wrkDouble = 0.0;
+  } else if (menuIndex == 3 || menuIndex == 4 || menuIndex == 6 || menuIndex == 8) {
+    menuIndex = 2;
+    menuCounter = 1;
+  } else if (menuIndex == 2 || menuIndex == 7) {
+    menuIndex = 0;
+    menuCounter = 1;
   }
 }
 
 // -----------------------------------------------------------
 // Parameter Calculations
 // -----------------------------------------------------------
+// Live edit of the selected item's parameter from the encoder count, committed on the button press
 void calcParameters() {
+  MenuItem item;
+
+  if (!menuItemLoad(menuIndex, menuCounter, batchWaiting(), &item) || item.type == MI_LINK || item.type == MI_ACTION) {
+    return;
+  }
+
+  if (item.type == MI_DOUBLE) {
+    wrkDouble = ((float)selectCounter * item.step * 0.01) + *(double *)item.param;
+    wrkDouble = constrain(wrkDouble, (double)item.minVal, (double)item.maxVal);
+    if (encSW) {
+      *(double *)item.param = wrkDouble;
+    }
+  } else {
+    wrkInt = constrain(selectCounter * item.step + *(uint8_t *)item.param, item.minVal, item.maxVal);
+    if (encSW) {
+      *(uint8_t *)item.param = wrkInt;
+      if (item.type == MI_NAME) {       // A rename is saved straight away, with the profile
+        profileSave(NULL);
+      }
+    }
+  }
+
+  if (encSW) {
+    selectCounter = 0;
+    wrkInt = 0;
+    wrkDouble = 0.0;
+  }
+}
+
+void pidLoop1() {
+  pid1_Input = steinhart1;
+  hotPlate1PID.Compute();
+  analogWrite(pwmPin1, constrain(pid1_Output + ilcFeedforward[0], 0, 255));   // Apply learned feedforward (0 when not learning)
+  if (pid1_Output + ilcFeedforward[0] < MODEL_SAT_OUTPUT) {
+    plateUnsaturated |= 1;
+  }
+} 
+
+void pidLoop2() {
+  pid2_Input = steinhart2;
+  hotPlate2PID.Compute();
+  analogWrite(pwmPin2, constrain(pid2_Output + ilcFeedforward[1], 0, 255));   // Apply learned feedforward (0 when not learning)
+  if (pid2_Output + ilcFeedforward[1] < MODEL_SAT_OUTPUT) {
+    plateUnsaturated |= 2;
+  }
+} 
+
+// -----------------------------------------------------------
+// Display, Menu Navigation, & Encoder Selection Handling
+// -----------------------------------------------------------
+void saveComplete() {
+  saveQueued = 0;
+  menuIndex = 2;            // Return to Config Menu
+  menuCounter = 1;
+}
+
+void updateCursorPosition() {
+  const MenuItem *items;
+  MenuItem item;
+  uint8_t i;
+
+  if (menuIndex == 5) {       //  Save Configuration - queue the writes once, saveComplete() returns to the Config Menu
+    if (saveQueued) {
+      return;
+    }
+    configSave(NULL);
+    profileSave(saveComplete);
+    saveQueued = 1;
+    return;
+  }
+
+  if (menuIndex == 8) {       // Run History - keep the shown record in step with the selected (or being selected) record
+    i = selectFlag ? wrkInt : histView;
+    if (i != histShownIndex) {
+      histShownIndex = i;
+      if (!histLoad(i, histShown)) {
+        histShown.crc = ~eeCrc8(&histShown, offsetof(RunRecord, crc));   // Mark as no record
+      }
+    }
+  }
+
+  // Generic navigation from the screen's item table
+  selectIndexMax = menuItems(menuIndex, batchWaiting(), &items);
+  if (menuCounter > selectIndexMax) {   // Item list of the screen shrank (batch cycle state change)
+    menuCounter = selectIndexMax;
+  }
+  if (!menuItemLoad(menuIndex, menuCounter, batchWaiting(), &item)) {
+    return;
+  }
+  curPos[0] = item.x;
+  curPos[1] = item.y;
+  if (encSW) {
+    if (item.type == MI_LINK) {
+      menuIndex = item.target;
+      menuCounter = 1;
+    } else if (item.type == MI_ACTION) {
+      menuAction(item.target);
+    } else if (item.type == MI_PROFILE) {
+      profileSelect(item.minVal);
+    } else {
+      selectFlag = !selectFlag;
+    }
+  }
+}
+
+// Graph screen partial update - called with no frame in progress, sends at most one tile row per call. The header rows are
+// rewritten once per second, the plot area only in the tile columns that received new samples.
+void graphUpdate() {
+  uint8_t row = 0;
+  uint8_t x;
+
+  if (dispShown.menuIndex != 97 || dispShown.thermistor1Fail || dispShown.thermistor2Fail) {
+    return;
+  }
+  if (graphHeaderSecond != runningSecondCounter) {
+    graphHeaderSecond = runningSecondCounter;
+    graphDirtyRows |= (1 << GRAPH_TOP_ROW) - 1;
+  }
+  if ((graphDirtyRows >> GRAPH_TOP_ROW) == 0 && graphDrawn < graphCount) {
+    graphTileFrom = graphDrawn / 8;
+    if (graphDrawn == 0) {          // Redraw the full width - clears a previous run / scrolled samples
+      graphTileTo = GRAPH_SAMPLES / 8 - 1;
+    } else {
+      graphTileTo = (graphCount - 1) / 8;
+    }
+    graphDrawn = graphCount;
+    graphDirtyRows |= (uint8_t)(0xFF << GRAPH_TOP_ROW);
+  }
+  if (graphDirtyRows == 0) {
+    return;
+  }
+  while (!(graphDirtyRows & (1 << row))) {
+    row++;
+  }
+  graphDirtyRows &= ~(1 << row);
+
+  u8g2.setBufferCurrTileRow(row);   // Render only this page into the page buffer
+  u8g2.clearBuffer();
+  if (row < GRAPH_TOP_ROW) {
+    graphDrawHeader();
+    u8g2.sendBuffer();
+  } else {
+    for (x = graphTileFrom * 8; x < graphCount && x < (graphTileTo + 1) * 8; x++) {
+      graphDrawColumn(x);
+    }
+    u8x8_DrawTile(u8g2.getU8x8(), graphTileFrom, row, graphTileTo - graphTileFrom + 1, u8g2.getBufferPtr() + graphTileFrom * 8);
+  }
+}
+
+// Page clipping - true when a line of text at baseline y reaches into the page being rendered. Elements off the page are
+// skipped instead of being laid out & clipped pixel by pixel by u8g2 on every page of the frame.
+bool textOnPage(uint8_t y) {
+  int top = u8g2.getBufferCurrTileRow() * 8;
+  if (y + TEXT_DESCENT >= top && y - TEXT_ASCENT < top + 8) {
+    return true;
+  }
+#ifdef PERF_STATS
+  perfSkippedDraws++;
+#endif
+  return false;
+}
+
+// Inverse header banner across the top line - drawButtonUTF8 takes a RAM string, the flash text is copied for the draw
+#define BANNER_CHARS 22
+void drawBanner(const __FlashStringHelper *text) {
+  char buf[BANNER_CHARS + 1];
+  strncpy_P(buf, (const char *)text, BANNER_CHARS);
+  buf[BANNER_CHARS] = 0;
+  u8g2.drawButtonUTF8(0, 8, U8G2_BTN_INV, 0, 0, 1, buf);
+}
 
-  if (menuIndex == 3) {     // Reflow Profile
-    wrkInt = selectCounter + parametersReflow[menuCounter - 1];
+// Draw a menu item - label, then the parameter value (boxed while it is being edited)
+void menuDrawItem(const MenuItem &item, bool editing, const DisplayModel &d) {
+  uint8_t value;
+
+  if (item.label == NULL || !textOnPage(item.y)) {
+    return;
+  }
+  u8g2.setCursor(item.x + MENU_CHAR_W, item.y);
+  u8g2.print((const __FlashStringHelper *)item.label);
+  if (item.type == MI_LINK || item.type == MI_ACTION) {
+    return;
+  }
+  if (item.type == MI_PROFILE) {        // Slot number (* = active) & name
+    u8g2.print(item.minVal + 1);
+    u8g2.print(item.minVal == d.profileActive ? '*' : ':');
+    if (profileIndex.nameId[item.minVal] == PROFILE_EMPTY) {
+      u8g2.print(F("-"));
+    } else {
+      u8g2.print((const __FlashStringHelper *)profileNames[profileIndex.nameId[item.minVal]]);
+    }
+    return;
+  }
+  if (editing) {
+    u8g2.drawFrame(item.x + MENU_CHAR_W * (strlen_P(item.label) + 1) - 2, item.y - 9, item.frameW, 11);
+  }
+
+  if (item.type == MI_DOUBLE) {
+    if (editing) {
+      printFixed(u8g2, d.wrkDouble, 2, 0);
+    } else {
+      printFixed(u8g2, *(double *)item.param, 2, 0);
+    }
+    return;
+  }
+
+  if (editing) {
+    value = d.wrkInt;
+  } else {
+    value = *(uint8_t *)item.param;
+  }
+  if (item.type == MI_NAME) {
+    u8g2.print((const __FlashStringHelper *)profileNames[value]);
+    return;
+  }
+  if (item.type == MI_ONOFF) {
+    if (value == 1) {
+      u8g2.print(F("ON"));
+    } else {
+      u8g2.print(F("OFF"));
+    }
+    return;
+  }
+  if (value == 0 && (item.type == MI_UINT8_OFF || item.type == MI_TENTHS_OFF)) {
+    u8g2.print(F("OFF"));
+    return;
+  }
+  if (item.type == MI_TENTHS_OFF) {
+    char buf[FMT_BUF_SIZE];
+    u8g2.print(formatFixed(buf, value, 1, 0));
+  } else {
+    u8g2.print(value);
+  }
+  if (item.unit != NULL) {
+    u8g2.print((const __FlashStringHelper *)item.unit);
+  }
+}
+
+// -----------------------------------------------------------
+// u8x8 Tile Mode Rendering (text only screens)
+// -----------------------------------------------------------
+// The main, configuration & confirm screens are plain text on the 8x8 character grid. They are written as u8x8 font tiles
+// straight to the display - no page buffer rendering - one 16 character row at a time, and a row is only sent when its
+// text differs from what the display already shows. Item positions come from the same descriptor tables (tile column =
+// x / 8, tile row = (y - 1) / 8).
+bool menuTileScreen(uint8_t index) {
+  return index <= 2;
+}
 
-    if (encSW) {
-      parametersReflow[menuCounter - 1] = wrkInt;
-      selectCounter = 0;
-      wrkInt = 0;
-      wrkDouble = 0.0;
+// One 16 character tile row, filled through the Arduino Print interface
+class TileRow : public Print {
+  public:
+    char text[17];
+    uint8_t col;
+    bool inverse;
+
+    TileRow() {
+      memset(text, ' ', 16);
+      text[16] = 0;
+      col = 0;
+      inverse = 0;
     }
-  }
-
-  if (menuIndex == 4) {     // PID Parameters
-    wrkDouble = ((float)selectCounter * 0.01) + parametersPID[menuCounter - 1];
-    if (wrkDouble < 0 ) {
-      wrkDouble = 0;
+    void setCol(uint8_t c) {
+      col = c;
     }
-
-    if (encSW) {
-      parametersPID[menuCounter - 1] = wrkDouble;
-      selectCounter = 0;
-      wrkInt = 0;
-      wrkDouble = 0.0;
+    size_t write(uint8_t c) {
+      if (col >= 16) {
+        return 0;
+      }
+      text[col++] = c;
+      return 1;
     }
+    using Print::write;
+};
+
+void tileBuildRow(TileRow &line, uint8_t row, const DisplayModel &d, bool waiting) {
+  const MenuItem *items;
+  MenuItem item;
+  const char *title;
+  uint8_t itemCount, i;
+
+  ////////////////// Header
+  title = (const char *)pgm_read_ptr(&menuScreen(d.menuIndex)->title);
+  if (row == 0 && d.platesHot) {
+    line.inverse = 1;
+    line.print(F(" CAUTION - HOT! "));
+  } else if (row == 0 && title != NULL) {
+    line.print((const __FlashStringHelper *)title);
   }
 
-  if (menuIndex == 98) {     // Running - Const Temp SP
-    wrkInt = selectCounter + constTempSP;
+  ////////////////// Screen specific content
+  switch (d.menuIndex) {
+    case 0:   // MAIN MENU
+      if (row == 7) {
+        line.print(F("T1:"));
+        printFixed(line, d.T1Disp, 1, 5);
+        line.setCol(8);
+        line.print(F("T2:"));
+        printFixed(line, d.T2Disp, 1, 5);
+      }
+      break;
+    case 1:   // CONFIRM
+      if (row == 2) {
+        line.print(F("Confirm to "));
+        if (d.startConfirm == 1) {
+          line.print(F("START"));
+        } else {
+          line.print(F("STOP"));
+        }
+      } else if (row == 3) {
+        line.setCol(1);
+        if (d.runningMode == 0) {
+          line.print(F("Constant Temp"));
+        } else if (d.batchMode == 1) {
+          line.print(F("Batch x "));
+          line.print(parametersProcess[2]);
+        } else {
+          line.print(F("Reflow Profile"));
+        }
+      } else if (row == 6 && d.startConfirm == 1 && d.runningMode == 1) {   // Pre-start feasibility & run time prediction
+        line.print(F("Est. time "));
+        line.print(predictedRunTime / 60);
+        line.print(F("m"));
+        line.print(predictedRunTime % 60);
+        line.print(F("s"));
+      } else if (row == 7 && d.startConfirm == 1 && d.runningMode == 1) {
+        if (infeasibleSegments & 0x01) {
+          line.print(F("! RAMP too fast"));
+        } else if (infeasibleSegments & 0x02) {
+          line.print(F("! SOAK too fast"));
+        } else if (infeasibleSegments & 0x04) {
+          line.print(F("!RFLW RAMP fast"));
+        } else if (infeasibleSegments & 0x08) {
+          line.print(F("!T3 unreachable"));
+        } else {
+          line.print(F("Profile OK"));
+        }
+      }
+      break;
+  }
 
-    if (encSW) {
-      constTempSP = wrkInt;
-      selectCounter = 0;
-      wrkInt = 0;
-      wrkDouble = 0.0;
+  ////////////////// Items & cursor
+  itemCount = menuItems(d.menuIndex, waiting, &items);
+  for (i = 0; i < itemCount; i++) {
+    memcpy_P(&item, &items[i], sizeof(MenuItem));
+    if (item.label == NULL || (item.y - 1) / 8 != row) {
+      continue;
     }
+    line.setCol(item.x / 8);
+    if (d.menuCounter == i + 1) {
+      line.print('>');
+    }
+    line.setCol(item.x / 8 + 1);
+    line.print((const __FlashStringHelper *)item.label);
   }
 }
 
-void pidLoop1() {
-  pid1_Input = steinhart1;
-  hotPlate1PID.Compute();
-  analogWrite(pwmPin1, pid1_Output);
-} 
+void tileSendRow(uint8_t row, const DisplayModel &d, bool waiting) {
+  TileRow line;
+  uint8_t hash = 0;
+  uint8_t i;
 
-void pidLoop2() {
-  pid2_Input = steinhart2;
-  hotPlate2PID.Compute();
-  analogWrite(pwmPin2, pid2_Output);
-} 
+  tileBuildRow(line, row, d, waiting);
+  for (i = 0; i < 16; i++) {
+    hash = _crc8_ccitt_update(hash, line.text[i]);
+  }
+  hash = _crc8_ccitt_update(hash, line.inverse);
+  if ((tileRowsValid & (1 << row)) && tileRowHash[row] == hash) {
+    return;
+  }
+  u8x8_SetFont(u8g2.getU8x8(), u8x8_font_chroma48medium8_r);
+  u8x8_SetInverseFont(u8g2.getU8x8(), line.inverse);
+  u8x8_DrawString(u8g2.getU8x8(), 0, row, line.text);
+  u8x8_SetInverseFont(u8g2.getU8x8(), 0);
+  tileRowHash[row] = hash;
+  tileRowsValid |= (1 << row);
+}
 
 // -----------------------------------------------------------
-// Display, Menu Navigation, & Encoder Selection Handling
+// Live Field Updates (running screens)
 // -----------------------------------------------------------
-void updateCursorPosition() {
-  int i = 0;
-
-  switch (menuIndex) {
-    curPos[0] = 0;
-    curPos[1] = 0;
-    case 0:  // MAIN MENU
-      curPos[0] = 0;
-      if (menuCounter == 1) {
-        curPos[1] = 19;
-      } else if (menuCounter == 2) {
-        curPos[1] = 27;        
-      } else {
-        curPos[1] = 50; 
-      }
-      if (encSW) {
-        if (menuCounter == 1) {           // Start Reflow Selected
-          runningMode = 1;
-          startConfirm = 1;
-          menuIndex = 1;
-        } else if (menuCounter == 2) {    // Start Const. Temp Selected
-          runningMode = 0;
-          startConfirm = 1;
-          menuIndex = 1;
-        } else if (menuCounter == 3) {
-          menuIndex = 2;
-        }
-        menuCounter = 1;
-      }
+// Once per second only a few values change on the running screens. When nothing but these live values changed, the old and
+// new text of each field is compared character by character, and only the tiles covering the changed characters are
+// re-rendered & sent instead of the whole frame.
+#define LF_TIME 0
+#define LF_COOL 1
+#define LF_T1 2
+#define LF_T2 3
+#define LF_SP 4
+#define LF_RMS 5
+#define LF_T1_C 6
+#define LF_T2_C 7
+
+struct LiveField {
+  uint8_t menuIndex;
+  uint8_t x, y;                     // Value position (after the label)
+  uint8_t source;
+};
+
+const LiveField liveFields[] PROGMEM = {
+  { 99, 95, 24, LF_TIME },
+  { 99, 36, 32, LF_COOL },
+  { 99, 24, 40, LF_T1 },
+  { 99, 90, 40, LF_SP },
+  { 99, 24, 48, LF_T2 },
+  { 99, 96, 48, LF_RMS },
+  { 98, 30, 24, LF_T1_C },
+  { 98, 30, 32, LF_T2_C },
+};
+
+// Print a live value - shared by the frame renderer & the field diff so both see exactly the same text
+void liveFieldPrint(uint8_t source, const DisplayModel &d, Print &out) {
+  switch (source) {
+    case LF_TIME:
+      out.print(d.runningSecondCounter);
+      out.print(F(" s"));
       break;
-    case 1:  // CONFIRM DIALOG
-      if (menuCounter == 1) {
-        curPos[0] = 29;  curPos[1] = 45;
-      } else {
-        curPos[0] = 69;  curPos[1] = 45;
-      }
-      if (encSW) {
-        if (menuCounter == 1) {     // ----- NO Selection -----
-          if (startConfirm == 1) {  // If Start Confirm True, profile is NOT running, selecing 'NO' would fall back to main menu
-            running = 0;
-            menuIndex = 0;
-            menuCounter = 1;
-            startConfirm = 0;
-          } else {                  // If Start Confirm False, profile IS running, selecing 'NO' would fall back to running screen to continue running
-            running = 1;            
-            if (runningMode == 1) {
-              menuIndex = 99;
-            } else {
-              menuIndex = 98;
-            }
-            menuCounter = 1;
-          }
-        }
-        if (menuCounter == 2) {     // ----- YES SELECTION -----
-          if (startConfirm == 1) {  // if Start Confirm True, selecting 'Yes' would START running the profile
-            running = 1; 
-            if (runningMode == 1) {
-              menuIndex = 99;
-            } else {
-              menuIndex = 98;
-            }
-            menuCounter = 1;
-            startConfirm = 0;
-          } else {                  // if Start Confirm False, profile is running. Selecting 'Yes' would STOP running the profile
-            running = 0;            
-            menuIndex = 0;
-            menuCounter = 1;
-          }
-        }
+    case LF_COOL:
+      if (d.runningState >= 5) {
+        printFixed(out, d.coolRate, 2, 5);
+        out.print(F(" C/s"));
       }
       break;
-    case 2:  // CONFIGURATION MENU
-      curPos[0] = 0;
-      switch (menuCounter) {
-        case 1:
-          curPos[1] = 19;
-          break;
-        case 2:
-          curPos[1] = 27;
-          break;
-        case 3:
-          curPos[1] = 43;
-          break;
-        case 4:
-          curPos[1] = 64;
-          break;
-      }
-      if (encSW) {
-        if (menuCounter == 4) {           // Back selection - Return to Main Menu
-          menuIndex = 0;
-          menuCounter = 1;
-        } else {
-          menuIndex = menuCounter + 2;    // Offset selection by 2
-          menuCounter = 1;
-        }
-      }
+    case LF_T1:
+      printFixed(out, d.T1Disp, 2, 6);
       break;
-    case 3:  // REFLOW PROFILE
-      if ((menuCounter < 8 && menuCounter % 2 == 1) || menuCounter == 8) {
-        curPos[0] = 0;
-      } else if (menuCounter < 8 && menuCounter % 2 == 0) {
-        curPos[0] = 66;
-      }
-      switch (menuCounter) {
-        case 1: curPos[1] = 19; break;  // T1
-        case 2: curPos[1] = 19; break;  // t1
-        case 3: curPos[1] = 29; break;  // T2
-        case 4: curPos[1] = 29; break;  // t2
-        case 5: curPos[1] = 39; break;  // T3
-        case 6: curPos[1] = 39; break;  // t3
-        case 7: curPos[1] = 49; break;  // Reflow Duration
-        case 8: curPos[1] = 64; break;  // Back
-      }
-      if (encSW) {
-        if (menuCounter == 8) {
-          menuIndex = 2;                // Return to Config Menu
-          menuCounter = 1;
-        } else {
-          selectFlag = !selectFlag;
-        }
-      }
+    case LF_T2:
+      printFixed(out, d.T2Disp, 2, 6);
       break;
-    case 4:  //  PID Loop Tuning
-      switch (menuCounter) {
-          case 1:  curPos[0] = 0;  curPos[1] = 19; break;  // Kp1
-          case 2:  curPos[0] = 0;  curPos[1] = 29; break;  // Ki1
-          case 3:  curPos[0] = 0;  curPos[1] = 39; break;  // Kd1
-          case 4:  curPos[0] = 66; curPos[1] = 19; break;  // Kp2
-          case 5:  curPos[0] = 66; curPos[1] = 29; break;  // Ki2
-          case 6:  curPos[0] = 66; curPos[1] = 39; break;  // Kd2
-          case 7:  curPos[0] = 0;  curPos[1] = 64; break;  // Back
-      }
-      if (encSW) {
-        if (menuCounter == 7) {
-          menuIndex = 2;              // Return to Config Menu
-          menuCounter = 1;
-        } else {
-          selectFlag = !selectFlag;
-        }
-      }
+    case LF_SP:
+      printFixed(out, d.pid_Setpoint, 2, 6);
       break;
-    case 5:   //  Save Configuration
-      writeUInt8TArrayIntoEEPROM(1, parametersReflow, 7);   // Write Reflow Paramter Data to EEPROM
-      for (i = 0; i < 6; i++) {                             // Convert PID paramters to INT for storage
-        parametersPIDint[i] = parametersPID[i] * 100;
-      }
-      writeIntArrayIntoEEPROM(8, parametersPIDint, 6);      // Write PID Parameter Data to EEPROM
-      delay(3000);
-      menuIndex = 2;                  // Return to Config Menu
-      menuCounter = 1;
+    case LF_RMS:
+      printFixed(out, d.trackingRMS, 2, 5);
       break;
-    case 98:  //  Running - Constant Temp Mode
-      curPos[0] = 0; 
-      if (menuCounter == 1) {
-        curPos[1] = 48;
-      } else {
-        curPos[1] = 64;
-      }
-      if (encSW) {
-        if (menuCounter == 2) {
-          startConfirm = 0;
-          menuIndex = 1;
-          menuCounter = 1;
-        } else {
-          selectFlag = !selectFlag;
-        }
-      }   
+    case LF_T1_C:
+      printFixed(out, d.T1Disp, 2, 6);
+      out.print(F(" C"));
       break;
-    case 99:  //  Running - Reflow Profile Mode
-      curPos[0] = 0;
-      curPos[1] = 56;
-      if (encSW) {
-        startConfirm = 0;
-        menuIndex = 1;
-        menuCounter = 1;
-      }    
+    case LF_T2_C:
+      printFixed(out, d.T2Disp, 2, 6);
+      out.print(F(" C"));
       break;
   }
 }
 
+// Mark the tiles covering the characters of each live field that differ between the shown and the new model
+void liveFieldDiff(const DisplayModel &was, const DisplayModel &now) {
+  LiveField field;
+  uint16_t mask;
+  uint8_t i, c0, c1, t, page;
+  int x0, x1;
+
+  memset(fieldDirtyTiles, 0, sizeof(fieldDirtyTiles));
+  for (i = 0; i < sizeof(liveFields) / sizeof(liveFields[0]); i++) {
+    memcpy_P(&field, &liveFields[i], sizeof(LiveField));
+    if (field.menuIndex != now.menuIndex) {
+      continue;
+    }
+    TileRow before, after;
+    liveFieldPrint(field.source, was, before);
+    liveFieldPrint(field.source, now, after);
+    c0 = 0;
+    while (c0 < 16 && before.text[c0] == after.text[c0]) {
+      c0++;
+    }
+    if (c0 == 16) {
+      continue;
+    }
+    c1 = 15;
+    while (before.text[c1] == after.text[c1]) {
+      c1--;
+    }
+    x0 = field.x + c0 * MENU_CHAR_W;
+    x1 = min(field.x + (c1 + 1) * MENU_CHAR_W - 1, 127);
+    if (x0 > 127) {
+      continue;
+    }
+    mask = 0;
+    for (t = x0 / 8; t <= x1 / 8; t++) {
+      mask |= (uint16_t)1 << t;
+    }
+    for (page = (field.y - TEXT_ASCENT) / 8; page <= (field.y + TEXT_DESCENT) / 8 && page < 8; page++) {
+      fieldDirtyTiles[page] |= mask;
+    }
+  }
+}
+
+// Send the dirty tile runs of the page just rendered into the page buffer
+void fieldSendPage(uint8_t page) {
+  uint16_t dirty = fieldDirtyTiles[page];
+  uint8_t t = 0;
+  uint8_t n;
+
+  while (t < 16) {
+    if (!(dirty & ((uint16_t)1 << t))) {
+      t++;
+      continue;
+    }
+    n = 0;
+    while (t + n < 16 && (dirty & ((uint16_t)1 << (t + n)))) {
+      n++;
+    }
+    u8x8_DrawTile(u8g2.getU8x8(), t, page, n, u8g2.getBufferPtr() + t * 8);
+    t += n;
+  }
+  fieldDirtyTiles[page] = 0;
+}
+
+// Build the render model from the current state - returns true (and takes the new snapshot) when the frame must be repainted
+bool displayModelChanged() {
+  DisplayModel m;
+
+  memset(&m, 0, sizeof(m));
+  m.menuIndex = menuIndex;
+  m.menuCounter = menuCounter;
+  m.curPos[0] = curPos[0];
+  m.curPos[1] = curPos[1];
+  m.selectFlag = selectFlag;
+  m.platesHot = (steinhart1 > 40.0 || steinhart2 > 40.00);
+  m.thermistor1Fail = thermistor1Fail;
+  m.thermistor2Fail = thermistor2Fail;
+  m.startConfirm = startConfirm;
+  m.runningMode = runningMode;
+  m.batchMode = batchMode;
+  m.batchGateOpen = batchGateOpen;
+  m.wrkInt = wrkInt;
+  m.wrkDouble = wrkDouble;
+  if (menuIndex == 5) {
+    m.saveProgress = eeWriterProgress();
+  }
+  m.profileActive = profileIndex.active;
+  if (menuIndex == 8) {
+    m.histShownIndex = histShownIndex;
+  }
+  if (menuIndex != 97) {        // The graph screen sends its live values as tile updates (graphUpdate), not as repaints
+    m.T1Disp = T1Disp;
+    m.T2Disp = T2Disp;
+  }
+  if (running && menuIndex != 97) {   // Running-only values - ignored while idle so standby control does not trigger repaints
+    m.runningState = runningState;
+    m.runningSecondCounter = runningSecondCounter;
+    m.pid_Setpoint = pid_Setpoint;
+    m.trackingRMS = trackingRMS;
+    m.coolRate = coolRate;
+    m.batchCycle = batchCycle;
+    m.batchPassCount = batchPassCount;
+    m.batchFailCount = batchFailCount;
+  }
+
+  if (memcmp(&m, &dispShown, sizeof(m)) == 0) {
+    return false;
+  }
+  displayMode = DISPLAY_PAGES;
+  if ((m.menuIndex == 98 || m.menuIndex == 99) && memcmp(&m, &dispShown, offsetof(DisplayModel, runningSecondCounter)) == 0) {
+    liveFieldDiff(dispShown, m);      // Only live values changed - re-send just the changed characters
+    displayMode = DISPLAY_FIELDS;
+  }
+  dispShown = m;
+  return true;
+}
+
+// Render one 128x8 page of the current frame per call, so a repaint never holds loop() for a whole frame. A new frame is
+// started (from a fresh render model snapshot) only once the previous one has been completely sent.
 void updateDisplay() {
-  u8g2.firstPage();
-  do {
+  const DisplayModel &d = dispShown;    // Draw from the frozen model so every page of a frame shows the same state
+  const MenuItem *items;
+  MenuItem item;
+  const char *title;
+  uint8_t itemCount, i;
+  uint8_t page = 0;
+  bool waiting;
+
+  if (displayBusy == 0) {
+    if (!displayModelChanged()) {
+      graphUpdate();
+      return;
+    }
+    if (displayMode == DISPLAY_FIELDS) {
+      // Live field update - fieldDirtyTiles was filled in by displayModelChanged()
+    } else if (menuTileScreen(d.menuIndex) && d.thermistor1Fail == 0 && d.thermistor2Fail == 0) {
+      displayMode = DISPLAY_TILES;
+      tileRow = 0;
+    } else {
+      displayMode = DISPLAY_PAGES;
+      tileRowsValid = 0;              // A page frame overwrites every tile row
+      u8g2.firstPage();
+    }
+  }
+  waiting = d.batchMode == 1 && d.runningState == 6 && d.batchCycle < parametersProcess[2];
+  if (displayMode == DISPLAY_TILES) { // One tile row per call, sent only when its text changed
+    tileSendRow(tileRow, d, waiting);
+    tileRow++;
+    displayBusy = (tileRow < 8);
+    return;
+  }
+  if (displayMode == DISPLAY_FIELDS) {  // Re-render the next page holding changed characters
+    while (page < 8 && fieldDirtyTiles[page] == 0) {
+      page++;
+    }
+    if (page == 8) {
+      displayBusy = 0;
+      return;
+    }
+    u8g2.setBufferCurrTileRow(page);
+    u8g2.clearBuffer();
+  }
+  {   // Draw the whole screen - u8g2 clips the drawing to the current page
     u8g2.setFont(u8g2_font_profont11_tr);
     u8g2.setFontMode(0);  // Opaque background, 1 = transparent
-    if (thermistor1Fail == 0 && thermistor2Fail == 0) {
-    // Define Menu Structure
-    switch (menuIndex) {
-      // ----------------------------------------
-      // 0) MAIN MENU
-      // ----------------------------------------
-      case 0:
-        selectIndexMax = 3;
-        u8g2.setCursor(0, 8);
-        if (steinhart1 > 40.0 || steinhart2 > 40.00) {
-          u8g2.drawButtonUTF8(0, 8, U8G2_BTN_INV, 0, 0, 1, " CAUTION - PLATES HOT ");
-        } else {
-          u8g2.print(F("      MAIN MENU      "));
-          u8g2.drawHLine(0, 9, 128);
-        }
-        u8g2.setCursor(6, 19);
-        u8g2.print(F(" Start Reflow"));
-        u8g2.setCursor(6, 27);
-        u8g2.print(F(" Start Const Temp"));
-        u8g2.setCursor(6, 50);
-        u8g2.print(F(" Configuration"));
-        u8g2.drawHLine(0, 54, 128);
-        u8g2.setCursor(0, 64);
-        u8g2.print(F("T1: "));  u8g2.print(steinhart1);
-        u8g2.setCursor(64, 64);
-        u8g2.print(F("T2: "));  u8g2.print(steinhart2);
-        u8g2.setCursor(curPos[0], curPos[1]);
-        u8g2.print(F(">"));
-        break;
+    if (d.thermistor1Fail == 0 && d.thermistor2Fail == 0) {
+    ////////////////// Header
+    title = (const char *)pgm_read_ptr(&menuScreen(d.menuIndex)->title);
+    if (!textOnPage(8)) {
+      // Header is off this page
+    } else if (d.platesHot && d.menuIndex < 97) {
+      drawBanner(F(" CAUTION - PLATES HOT "));
+    } else if (title != NULL) {
+      u8g2.setCursor(0, 8);
+      u8g2.print((const __FlashStringHelper *)title);
+      u8g2.drawHLine(0, 9, 128);
+    }
 
+    ////////////////// Screen specific content
+    switch (d.menuIndex) {
       // ----------------------------------------
-      // 1) CONFIRM
+      // 5) SAVE CONFIGURATION
       // ----------------------------------------
-      case 1:
-        selectIndexMax = 2;
-        if (steinhart1 > 40.0 || steinhart2 > 40.00) {
-          u8g2.drawButtonUTF8(0, 8, U8G2_BTN_INV, 0, 0, 1, " CAUTION - PLATES HOT ");
-        }
-        u8g2.setCursor(16, 20);
-        u8g2.print(F("Confirm to "));
-        if (startConfirm == 1) {
-          u8g2.print(F("START"));
-        } else {
-          u8g2.print(F("STOP"));
-        }
-        if (runningMode == 0) {
-          u8g2.setCursor(26, 30);
-          u8g2.print(F("Constant Temp"));
-        } else if (runningMode == 1) {
-          u8g2.setCursor(22, 30);
-          u8g2.print(F("Reflow Profile"));
+      case 5:
+        if (textOnPage(30)) {
+          u8g2.setCursor(30, 30);
+          u8g2.print(F("Saving Data"));
         }
-        u8g2.setCursor(35, 45);
-        u8g2.print(F("NO"));
-        u8g2.setCursor(75, 45);
-        u8g2.print(F("YES"));
-        u8g2.setCursor(curPos[0], curPos[1]);
-        u8g2.print(F(">"));
-
-        break;
-
-      // ----------------------------------------
-      // 2) CONFIGURATION MENU
-      // ----------------------------------------
-      case 2:
-        selectIndexMax = 4;
-
-        ////////////////// Header
-        u8g2.setCursor(0, 8);
-        if (steinhart1 > 40.0 || steinhart2 > 40.00) {
-          u8g2.drawButtonUTF8(0, 8, U8G2_BTN_INV, 0, 0, 1, " CAUTION - PLATES HOT ");
-        } else {
-          u8g2.print(F("     CONFIG MENU     "));
-          u8g2.drawHLine(0, 9, 128);
+        if (textOnPage(40)) {
+          u8g2.setCursor(36, 40);
+          u8g2.print(F("to EEPROM"));
         }
-        u8g2.drawHLine(0, 9, 128);
-
-        u8g2.setCursor(6, 19);
-        u8g2.print(F(" Reflow Profile"));
-        u8g2.setCursor(6, 27);
-        u8g2.print(F(" PID Parameters"));
-        u8g2.setCursor(6, 43);
-        u8g2.print(F(" Save Configuration"));
-        u8g2.setCursor(6, 64);
-        u8g2.print(F("BACK"));
-
-        u8g2.setCursor(curPos[0], curPos[1]);
-        u8g2.print(F(">"));
+        u8g2.drawFrame(14, 48, 100, 6);
+        u8g2.drawBox(14, 48, d.saveProgress, 6);
         break;
 
       // ----------------------------------------
-      // 3) SET REFLOW PROFILE
+      // 8) RUN HISTORY
       // ----------------------------------------
-      case 3:  // Reflow Profile
-        selectIndexMax = 8;
-
-        ////////////////// Header
-        u8g2.setCursor(0, 8);
-        if (steinhart1 > 40.0 || steinhart2 > 40.00) {
-          u8g2.drawButtonUTF8(0, 8, U8G2_BTN_INV, 0, 0, 1, " CAUTION - PLATES HOT ");
-        } else {
-          u8g2.println("   Reflow  Profile    ");
-          u8g2.drawHLine(0, 9, 128);
-        }
-        u8g2.drawHLine(0, 9, 128);
-
-        ////////////////// T1
-        u8g2.setCursor(6, 19);
-        u8g2.print(F("T1: "));
-        if (selectFlag == 1 && menuCounter == 1) {
-          u8g2.drawFrame(28, 10, 34, 11);
-          u8g2.print(wrkInt);
-        } else {
-          u8g2.print(parametersReflow[0]);
-        }
-        u8g2.print(F(" C"));
-
-        ////////////////// t1
-        u8g2.setCursor(72, 19);
-        u8g2.print(F("t1: "));
-        if (selectFlag == 1 && menuCounter == 2) {
-          u8g2.drawFrame(94, 10, 34, 11);
-          u8g2.print(wrkInt);
-      } else {
-        u8g2.print(parametersReflow[1]);
-        }
-        u8g2.print(F(" s"));
-
-        ////////////////// T2
-        u8g2.setCursor(6, 29);
-        u8g2.print(F("T2: "));
-        if (selectFlag == 1 && menuCounter == 3) {
-          u8g2.drawFrame(28, 20, 34, 11);
-          u8g2.print(wrkInt);
-      } else {
-        u8g2.print(parametersReflow[2]);
+      case 8:
+        if (histShown.crc != eeCrc8(&histShown, offsetof(RunRecord, crc))) {
+          if (textOnPage(34)) {
+            u8g2.setCursor(36, 34);
+            u8g2.print(F("No record"));
+          }
+          break;
         }
-        u8g2.print(F(" C"));
-
-        ////////////////// t2
-        u8g2.setCursor(72, 29);
-        u8g2.print(F("t2: "));
-        if (selectFlag == 1 && menuCounter == 4) {
-          u8g2.drawFrame(94, 20, 34, 11);
-          u8g2.print(wrkInt);
-      } else {
-        u8g2.print(parametersReflow[3]);
+        if (textOnPage(19)) {
+          u8g2.setCursor(66, 19);
+          u8g2.print(F("Slot "));
+          u8g2.print(histShown.slot + 1);
         }
-        u8g2.print(F(" s"));
-
-        ////////////////// T3
-        u8g2.setCursor(6, 39);
-        u8g2.print(F("T3: "));
-        if (selectFlag == 1 && menuCounter == 5) {
-          u8g2.drawFrame(28, 30, 34, 11);
-          u8g2.print(wrkInt);
-      } else {
-        u8g2.print(parametersReflow[4]);
+        if (textOnPage(29)) {
+          u8g2.setCursor(0, 29);
+          u8g2.print(F("Start: "));
+          u8g2.print(histShown.startT1);
+          u8g2.print('/');
+          u8g2.print(histShown.startT2);
+          u8g2.setCursor(84, 29);
+          u8g2.print(F("Pk:"));
+          u8g2.print(histShown.peak);
         }
-        u8g2.print(F(" C"));
-
-        ////////////////// t3
-        u8g2.setCursor(72, 39);
-        u8g2.print(F("t3: "));
-        if (selectFlag == 1 && menuCounter == 6) {
-          u8g2.drawFrame(94, 30, 34, 11);
-          u8g2.print(wrkInt);
-      } else {
-        u8g2.print(parametersReflow[5]);
+        if (textOnPage(39)) {
+          u8g2.setCursor(0, 39);
+          u8g2.print(F("TAL: "));
+          u8g2.print(histShown.tal);
+          u8g2.print('s');
+          u8g2.setCursor(66, 39);
+          u8g2.print(F("dT: "));
+          u8g2.print(histShown.maxDelta);
+          u8g2.print('C');
         }
-        u8g2.print(F(" s"));
-
-        ////////////////// Reflow Hold
-        u8g2.setCursor(6, 49);
-        u8g2.print(F("Reflow Hold: "));
-        if (selectFlag == 1 && menuCounter == 7) {
-          u8g2.drawFrame(82, 40, 34, 11);
-          u8g2.print(wrkInt);
-      } else {
-        u8g2.print(parametersReflow[6]);
+        if (textOnPage(49)) {
+          u8g2.setCursor(0, 49);
+          u8g2.print(F("Time: "));
+          u8g2.print(histShown.duration);
+          u8g2.print('s');
+          u8g2.setCursor(78, 49);
+          switch (histShown.fault) {
+            case HIST_OK:
+              if (histShown.batch == HIST_BATCH_PASS) {
+                u8g2.print(F("PASS"));
+              } else if (histShown.batch == HIST_BATCH_FAIL) {
+                u8g2.print(F("FAIL"));
+              } else {
+                u8g2.print(F("OK"));
+              }
+              break;
+            case HIST_ABORTED:
+              u8g2.print(F("ABORT"));
+              break;
+            default:
+              u8g2.print(F("T FAIL"));
+              break;
+          }
         }
-        u8g2.print(F(" s"));
-
-        ////////////////// Back Selection
-        u8g2.setCursor(6, 64);
-        u8g2.print(F("BACK"));
-
-        u8g2.setCursor(curPos[0], curPos[1]);
-        u8g2.print(F(">"));
         break;
 
       // ----------------------------------------
-      // 4) PID TUNING
+      // 9) RESUME INTERRUPTED RUN
       // ----------------------------------------
-      case 4:  // PID Tuning
-        selectIndexMax = 7;
-
-        ////////////////// Header
-        u8g2.setCursor(0, 8);
-        if (steinhart1 > 40.0 || steinhart2 > 40.00) {
-          u8g2.drawButtonUTF8(0, 8, U8G2_BTN_INV, 0, 0, 1, " CAUTION - PLATES HOT ");
-        } else {
-          u8g2.print(F("      PID Tuning     "));
-          u8g2.drawHLine(0, 9, 128);
-        }
-        u8g2.drawHLine(0, 9, 128);
-
-        ////////////////// Kp1
-        u8g2.setCursor(6, 19);
-        u8g2.print(F("Kp1: "));
-        if (selectFlag == 1 && menuCounter == 1) {
-          u8g2.drawFrame(34, 10, 28, 11);
-          u8g2.print(wrkDouble);
-      } else {
-        u8g2.print(parametersPID[0]);
-        }
-
-        ////////////////// Ki1
-        u8g2.setCursor(6, 29);
-        u8g2.print(F("Ki1: "));
-        if (selectFlag == 1 && menuCounter == 2) {
-          u8g2.drawFrame(34, 20, 28, 11);
-          u8g2.print(wrkDouble);
-      } else {
-        u8g2.print(parametersPID[1]);
-        }
-
-        ////////////////// Kd1
-        u8g2.setCursor(6, 39);
-        u8g2.print(F("Kd1: "));
-        if (selectFlag == 1 && menuCounter == 3) {
-          u8g2.drawFrame(34, 30, 28, 11);
-          u8g2.print(wrkDouble);
-      } else {
-        u8g2.print(parametersPID[2]);
-        }
-
-        ////////////////// Kp2
-        u8g2.setCursor(72, 19);
-        u8g2.print(F("Kp2: "));
-        if (selectFlag == 1 && menuCounter == 4) {
-          u8g2.drawFrame(100, 10, 28, 11);
-          u8g2.print(wrkDouble);
-      } else {
-        u8g2.print(parametersPID[3]);
+      case 9:
+        if (textOnPage(24)) {
+          u8g2.setCursor(0, 24);
+          switch (cpRecord.state) {
+            case 1: u8g2.print(F("RAMP")); break;
+            case 2: u8g2.print(F("SOAK")); break;
+            case 3: u8g2.print(F("RFLW RAMP")); break;
+            case 4: u8g2.print(F("REFLOW")); break;
+            case 5: u8g2.print(F("COOLING")); break;
+          }
+          u8g2.setCursor(72, 24);
+          u8g2.print(F("at "));
+          u8g2.print(cpRecord.second);
+          u8g2.print(F(" s"));
         }
-
-        ////////////////// Ki2
-        u8g2.setCursor(72, 29);
-        u8g2.print(F("Ki2: "));
-        if (selectFlag == 1 && menuCounter == 5) {
-          u8g2.drawFrame(100, 20, 28, 11);
-          u8g2.print(wrkDouble);
-      } else {
-        u8g2.print(parametersPID[4]);
+        if (textOnPage(34)) {
+          u8g2.setCursor(0, 34);
+          u8g2.print(F("SP: "));
+          u8g2.print(cpRecord.setpoint);
+          u8g2.setCursor(60, 34);
+          u8g2.print(F("Now: "));
+          printFixed(u8g2, min(d.T1Disp, d.T2Disp), 0, 0);
         }
-
-        ////////////////// Kd2
-        u8g2.setCursor(72, 39);
-        u8g2.print(F("Kd2: "));
-        if (selectFlag == 1 && menuCounter == 6) {
-          u8g2.drawFrame(100, 30, 28, 11);
-          u8g2.print(wrkDouble);
-      } else {
-        u8g2.print(parametersPID[5]);
+        if (textOnPage(46)) {
+          u8g2.setCursor(0, 46);
+          if (cpResumable()) {
+            u8g2.print(F("Can be resumed"));
+          } else {
+            u8g2.print(F("Cannot resume"));
+          }
         }
-
-        ////////////////// Back Selection
-        u8g2.setCursor(6, 64);
-        u8g2.print(F("BACK"));
-
-        u8g2.setCursor(curPos[0], curPos[1]);
-        u8g2.print(F(">"));
         break;
-      
+
       // ----------------------------------------
-      // 5) SAVE CONFIGURATION
+      // 97) RUNNING - TREND GRAPH
       // ----------------------------------------
-      case 5:
-        if (steinhart1 > 40.0 || steinhart2 > 40.00) {
-          u8g2.drawButtonUTF8(0, 8, U8G2_BTN_INV, 0, 0, 1, " CAUTION - PLATES HOT ");
-        }
-        u8g2.setCursor(30, 30);
-        u8g2.print(F("Saving Data"));
-        u8g2.setCursor(36, 40);
-        u8g2.print(F("to EEPROM"));
+      case 97:
+        graphDrawn = 0;                 // The repaint clears the screen - header & plot are redrawn by graphUpdate() once
+        graphHeaderSecond = -1;         // the frame has been sent
+        graphDirtyRows = 0;
         break;
 
       // ----------------------------------------
       // 98) RUNNING - CONSTANT TEMP
       // ----------------------------------------
-      case 98:  // Running - Constant Temp
-        selectIndexMax = 2;
-        u8g2.drawButtonUTF8(0, 8, U8G2_BTN_INV, 0, 0, 1, " CONST TEMP RUNNING ");
-        u8g2.setCursor(6, 24);
-        u8g2.print(F("T1: "));
-        u8g2.print(T1Disp);
-        u8g2.print(F(" C"));
-        u8g2.setCursor(6, 32);
-        u8g2.print(F("T2: "));
-        u8g2.print(T2Disp);
-        u8g2.print(F(" C"));
-        u8g2.setCursor(6, 64);
-        u8g2.setCursor(6, 48);
-        u8g2.print(F("SP: "));
-        if (selectFlag == 1 && menuCounter == 1) {
-          u8g2.drawFrame(28, 39, 34, 11);
-          u8g2.print(wrkInt);
-        } else {
-          u8g2.print(constTempSP);
+      case 98:
+        if (textOnPage(8)) {
+          drawBanner(F(" CONST TEMP RUNNING "));
+        }
+        if (textOnPage(24)) {
+          u8g2.setCursor(6, 24);
+          u8g2.print(F("T1: "));
+          liveFieldPrint(LF_T1_C, d, u8g2);
+        }
+        if (textOnPage(32)) {
+          u8g2.setCursor(6, 32);
+          u8g2.print(F("T2: "));
+          liveFieldPrint(LF_T2_C, d, u8g2);
         }
-        u8g2.print(F(" C"));
-        u8g2.setCursor(6, 64);
-        u8g2.print(F("STOP"));
-
-        u8g2.setCursor(curPos[0], curPos[1]);
-        u8g2.print(F(">"));
         break;
-      
+
       // ----------------------------------------
       // 99) RUNNING - REFLOW PROFILE
       // ----------------------------------------
-      case 99:  // Running - Reflow Profile
-        selectIndexMax = 1;
+      case 99:
         u8g2.setCursor(0, 8);
-        if (runningState == 5) {
-          u8g2.print(F("       COMPLETE      "));
+        if (!textOnPage(8)) {
+          // Header is off this page
+        } else if (d.runningState == 6 && waiting) {
+          u8g2.print(F("    CYCLE COMPLETE   "));
+          u8g2.drawHLine(0, 9, 128);
+        } else if (d.runningState == 6) {
+          drawBanner(F("    SAFE TO REMOVE    "));
+        } else if (d.runningState == 5) {
+          u8g2.print(F("    COOLING - HOT    "));
           u8g2.drawHLine(0, 9, 128);
+        } else if (d.batchMode == 1) {
+          drawBanner(F("    BATCH RUNNING     "));
         } else {
-          u8g2.drawButtonUTF8(0, 8, U8G2_BTN_INV, 0, 0, 1, "    REFLOW RUNNING    ");
+          drawBanner(F("    REFLOW RUNNING    "));
         }
-        u8g2.setCursor(0, 24);
-        switch (runningState) {
-          case 1:
-            u8g2.print(F("RAMP"));
-            break;
-          case 2:
-            u8g2.print(F("SOAK"));
-            break;
-          case 3:
-            u8g2.print(F("RFLW RAMP"));
-            break;
-          case 4:
-            u8g2.print(F("REFLOW"));
-            break;
-          case 5:
-            u8g2.print(F("COOLING"));
-            break;
+        if (textOnPage(24)) {
+          u8g2.setCursor(0, 24);
+          switch (d.runningState) {
+            case 1:
+              u8g2.print(F("RAMP"));
+              break;
+            case 2:
+              u8g2.print(F("SOAK"));
+              break;
+            case 3:
+              u8g2.print(F("RFLW RAMP"));
+              break;
+            case 4:
+              u8g2.print(F("REFLOW"));
+              break;
+            case 5:
+              u8g2.print(F("COOLING"));
+              break;
+            case 6:
+              if (waiting && d.batchGateOpen) {
+                u8g2.print(F("READY"));
+              } else if (waiting) {
+                u8g2.print(F("WAIT<"));
+                u8g2.print(parametersProcess[3]);
+                u8g2.print(F("C"));
+              } else {
+                u8g2.print(F("COMPLETE"));
+              }
+              break;
+          }
+          u8g2.setCursor(59, 24);
+          u8g2.print(F("Time: "));
+          liveFieldPrint(LF_TIME, d, u8g2);
+        }
+        if (d.runningState >= 5 && textOnPage(32)) {   // Live cooling rate while COOLING, average rate once COMPLETE
+          u8g2.setCursor(0, 32);
+          u8g2.print(F("Cool: "));
+          liveFieldPrint(LF_COOL, d, u8g2);
+        }
+        if (textOnPage(40)) {
+          u8g2.setCursor(0, 40);
+          u8g2.print(F("T1: "));
+          liveFieldPrint(LF_T1, d, u8g2);
+          u8g2.setCursor(66, 40);
+          u8g2.print(F("SP: "));
+          liveFieldPrint(LF_SP, d, u8g2);
+        }
+        if (textOnPage(48)) {
+          u8g2.setCursor(0, 48);
+          u8g2.print(F("T2: "));
+          liveFieldPrint(LF_T2, d, u8g2);
+          u8g2.setCursor(66, 48);
+          u8g2.print(F("RMS: "));
+          liveFieldPrint(LF_RMS, d, u8g2);
+        }
+        if (d.batchMode == 1 && textOnPage(56)) {
+          u8g2.setCursor(0, 56);
+          u8g2.print(F("Cycle "));
+          u8g2.print(d.batchCycle);
+          u8g2.print(F("/"));
+          u8g2.print(parametersProcess[2]);
+          u8g2.setCursor(66, 56);
+          u8g2.print(F("P:"));
+          u8g2.print(d.batchPassCount);
+          u8g2.print(F(" F:"));
+          u8g2.print(d.batchFailCount);
         }
-        u8g2.setCursor(59, 24);
-        u8g2.print(F("Time: "));
-        u8g2.print(runningSecondCounter);
-        u8g2.print(F(" s"));
-        u8g2.setCursor(0, 40);
-        u8g2.print(F("T1: "));
-        u8g2.print(T1Disp);
-        u8g2.setCursor(66, 40);
-        u8g2.print(F("SP: "));
-        u8g2.print(pid_Setpoint);
-        u8g2.setCursor(0, 48);
-        u8g2.print(F("T2: "));
-        u8g2.print(T2Disp);
-        u8g2.setCursor(0, 64);
-        u8g2.print(F("> STOP"));
         break;
     }
+
+    ////////////////// Items & cursor
+    itemCount = menuItems(d.menuIndex, waiting, &items);
+    for (i = 0; i < itemCount; i++) {
+      memcpy_P(&item, &items[i], sizeof(MenuItem));
+      menuDrawItem(item, d.selectFlag == 1 && d.menuCounter == i + 1, d);
+      if (d.menuCounter == i + 1 && item.label != NULL && textOnPage(d.curPos[1])) {
+        u8g2.setCursor(d.curPos[0], d.curPos[1]);
+        u8g2.print(F(">"));
+      }
+    }
     } else {
-      if (thermistor1Fail == 1 && thermistor2Fail == 0) {
+      if (d.thermistor1Fail == 1 && d.thermistor2Fail == 0) {
       u8g2.setCursor(12, 18);
       u8g2.print(F("Thermistor 1 Fail"));
-      } else if (thermistor1Fail == 0 && thermistor2Fail == 1) {
+      } else if (d.thermistor1Fail == 0 && d.thermistor2Fail == 1) {
         u8g2.setCursor(12, 18);
         u8g2.print(F("Thermistor 2 Fail"));
-      } else if (thermistor1Fail == 1 && thermistor2Fail == 1) {
+      } else if (d.thermistor1Fail == 1 && d.thermistor2Fail == 1) {
         u8g2.setCursor(10, 18);
         u8g2.print(F("Thermistors 1 & 2"));
         u8g2.setCursor(46, 26);
@@ -822,8 +2984,81 @@ void updateDisplay() {
 
       }
     }
-  } while (u8g2.nextPage());
+  }
+  if (displayMode == DISPLAY_FIELDS) {
+    fieldSendPage(page);
+    displayBusy = 0;
+    for (page = 0; page < 8; page++) {
+      if (fieldDirtyTiles[page] != 0) {
+        displayBusy = 1;
+      }
+    }
+  } else {
+    displayBusy = u8g2.nextPage();     // Send the page & advance, 0 once the last page of the frame has been sent
+  }
+}
+
+#ifdef PERF_STATS
+void perfReport() {
+  perfLoopCount++;
+  if (millis() - perfWindowStart >= 1000) {
+    uart.print(F("loops/s: "));
+    uart.print(perfLoopCount);
+    uart.print(F("  frames/s: "));
+    uart.print(perfFrameCount);
+    uart.print(F("  render us/s: "));
+    uart.print(perfFrameMicros);
+    uart.print(F("  us/frame: "));
+    uart.print(perfFrameCount > 0 ? perfFrameMicros / perfFrameCount : 0);
+#ifndef U8X8_HAVE_HW_I2C
+    uart.print(F("  i2c errors: "));
+    uart.print(twiErrors);
+#endif
+    uart.print(F("  max slice us: "));
+    uart.print(perfSliceMaxMicros);
+    uart.print(F("  clipped draws: "));
+    uart.println(perfSkippedDraws);
+    perfWindowStart = millis();
+    perfLoopCount = 0;
+    perfFrameCount = 0;
+    perfFrameMicros = 0;
+    perfSliceMaxMicros = 0;
+    perfSkippedDraws = 0;
+  }
+}
+
+// Discards printed characters - isolates the cost of number formatting in the benchmark
+class PerfNullPrint : public Print {
+  public:
+    size_t write(uint8_t c) {
+      return 1;
+    }
+    using Print::write;
+};
+
+// One-shot at boot: CPU cycles per formatted value, Print::printFloat vs the fixed-point formatter
+void perfFormatBenchmark() {
+  PerfNullPrint sink;
+  unsigned long t;
+  uint8_t i;
+
+  t = micros();
+  for (i = 0; i < 100; i++) {
+    sink.print(123.45 + i);
+  }
+  t = micros() - t;
+  uart.print(F("printFloat cycles/value: "));
+  uart.println(t * (F_CPU / 1000000L) / 100);
+
+  t = micros();
+  for (i = 0; i < 100; i++) {
+    printFixed(sink, 123.45 + i, 2, 6);
+  }
+  t = micros() - t;
+  uart.print(F("printFixed cycles/value: "));
+  uart.println(t * (F_CPU / 1000000L) / 100);
 }
+#endif
 
 // -----------------------------------------------------------
 // Temperature Readings and Calculations
@@ -914,48 +3149,115 @@ void reflowRunning() {
   // Ensure PID Loops are in AUTO 
   hotPlate1PID.SetMode(AUTOMATIC);
   hotPlate2PID.SetMode(AUTOMATIC);
+
+  // Track run peak temperatures for cycle grading
+  if (runningState < 5) {
+    runPeak1 = max(runPeak1, steinhart1);
+    runPeak2 = max(runPeak2, steinhart2);
+    runMaxDelta = max(runMaxDelta, (uint8_t)min(fabs(steinhart1 - steinhart2), 255));
+  }
+  if (thermistor1Fail || thermistor2Fail) {
+    histAppend(thermistor1Fail + 2 * thermistor2Fail);   // HIST_T1_FAIL, HIST_T2_FAIL or HIST_T1_T2_FAIL
+  }
   
   // Second Counter
-  if (runningState < 5) {
-    if(millis() - time_now > 1000){   // 1 Second timer - increment running second counter each time timer elapses. Update temperature display so it is more stable
-        time_now = millis();
+  if(millis() - time_now > 1000){   // 1 Second timer - increment running second counter each time timer elapses. Update temperature display so it is more stable
+      time_now = millis();
+      if (runningState < 6) {
         runningSecondCounter ++;
-        T1Disp = steinhart1;
-        T2Disp = steinhart2;
-    }
+      }
+      T1Disp = steinhart1;
+      T2Disp = steinhart2;
+      if (runningState < 6) {
+        if (runningSecondCounter % CP_INTERVAL == 0) {
+          cpWrite(runningState);
+        }
+        graphSample();
+        if (steinhart1 >= parametersProcess[8] && steinhart2 >= parametersProcess[8] && runTAL < 255) {
+          runTAL++;
+        }
+      }
+      if (runningState < 5) {
+        ilcSample();
+        modelSample();
+      } else if (runningState == 5) {
+        coolRate = coolPrevTemp - max(steinhart1, steinhart2);   // Log the measured 1 sec cooling rate
+        coolRateMax = max(coolRateMax, coolRate);
+        coolPrevTemp = max(steinhart1, steinhart2);
+      }
   }
 
   switch (runningState) {
     case 1:   // RAMP
-      pid_Setpoint = (((double)parametersReflow[0] - initTempSnapshot) / ((double)parametersReflow[1]) - 0) * (double)runningSecondCounter + initTempSnapshot;
+      pid_Setpoint = profileSetpoint(runningSecondCounter);
       if (runningSecondCounter >= parametersReflow[1]) {
         runningState = 2;
       }
       break;
     case 2:   // SOAK
-      pid_Setpoint = (((double)parametersReflow[2] - (double)parametersReflow[0]) / ((double)parametersReflow[3] - (double)parametersReflow[1])) * ((double)runningSecondCounter - (double)parametersReflow[1]) + (double)parametersReflow[0];
+      pid_Setpoint = profileSetpoint(runningSecondCounter);
       if (runningSecondCounter >= parametersReflow[3]) {
         runningState = 3;
       }
       break;
     case 3:   // REFLOW RAMP
-      pid_Setpoint = (((double)parametersReflow[4] - (double)parametersReflow[2]) / ((double)parametersReflow[5] - (double)parametersReflow[3])) * ((double)runningSecondCounter - (double)parametersReflow[3]) + (double)parametersReflow[2];
+      pid_Setpoint = profileSetpoint(runningSecondCounter);
       if (runningSecondCounter >= parametersReflow[5]) {
         runningState = 4;
       }
       break;
     case 4:   // REFLOW
-      pid_Setpoint = (double)parametersReflow[4];
+      pid_Setpoint = profileSetpoint(runningSecondCounter);
       if (runningSecondCounter >= (parametersReflow[5] + parametersReflow[6])) {
         runningState = 5;
+        coolStartSecond = runningSecondCounter;
+        coolPrevTemp = max(steinhart1, steinhart2);
+        coolRate = 0.0;
+        coolRateMax = 0.0;
+        ilcUpdate();                  // Completed run - refine the learned feedforward for the next run
+        modelSave();
+        if (batchMode == 1) {
+          batchRecordCycle();
+        }
+      }
+      break;
+    case 5:   // COOLING
+      if (parametersProcess[5] > 0) {
+        // Rate-limited cool-down: track a setpoint descending from T3 at the Cooling Rate, the heaters add residual power
+        // whenever the plates would otherwise cool faster than programmed
+        pid_Setpoint = profileSetpoint(runningSecondCounter);
+      } else {                        // Passive cooling
+        pid_Setpoint = 0;
+        hotPlate1PID.SetMode(MANUAL);
+        hotPlate2PID.SetMode(MANUAL);
+        pid1_Output = 0;
+        pid2_Output = 0;
+      }
+      if (steinhart1 <= parametersProcess[6] && steinhart2 <= parametersProcess[6]) {   // Declare SAFE TO REMOVE as soon as both plates reach the threshold
+        runningState = 6;
+        histAppend(HIST_OK);
+        cpWrite(0);
+        if (runningSecondCounter > coolStartSecond) {   // Log the average cooling rate over the COOLING state
+          coolRate = ((double)parametersReflow[4] - max(steinhart1, steinhart2)) / (double)(runningSecondCounter - coolStartSecond);
+          if (parametersProcess[5] == 0) {
+            modelCoolSample(coolRate);
+            modelSave();
+          }
+        }
       }
       break;
-    case 5:   // COOLING / COMPLETE
+    case 6:   // COMPLETE
       pid_Setpoint = 0;
       hotPlate1PID.SetMode(MANUAL);
       hotPlate2PID.SetMode(MANUAL);
       pid1_Output = 0;
       pid2_Output = 0;
+      if (batchWaiting()) {           // Cooldown gating - next cycle may start once both plates are below the Re-Entry Temp
+        batchGateOpen = (steinhart1 <= parametersProcess[3] && steinhart2 <= parametersProcess[3]);
+        if (batchGateOpen && parametersProcess[4] == 1) {
+          batchNextCycle();
+        }
+      }
       break;
   }
 
@@ -991,8 +3293,6 @@ void constTempRunning() {
 // Setup & Loop
 // -----------------------------------------------------------
 void setup() {
-  int i = 0;
-
   // ----------------------------------------
   // Set up funcitons for the rotary encoder
   // ----------------------------------------
@@ -1002,28 +3302,24 @@ void setup() {
   pinMode(encDT_inp, INPUT_PULLUP);
   pinMode(encSW_inp, INPUT_PULLUP);
 
-  attachInterrupt(digitalPinToInterrupt(encCLK_inp), isrEncCLK, CHANGE);
-  attachInterrupt(digitalPinToInterrupt(encDT_inp), isrEncDT, CHANGE);
+  PCMSK2 |= bit(PCINT18) | bit(PCINT19);   // Pin change interrupt on CLK (PD2) & DT (PD3)
+  PCIFR = bit(PCIF2);
+  PCICR |= bit(PCIE2);
+
+  // Timer2 in CTC mode at 1 kHz for the pushbutton debouncer (16 MHz / 64 / 250) - Timer0 is shared by millis() & the
+  // hotplate PWM outputs, Timer2 is otherwise unused
+  TCCR2A = bit(WGM21);
+  TCCR2B = bit(CS22);
+  OCR2A = 249;
+  TIMSK2 = bit(OCIE2A);
 
   // ----------------------------------------
   // Read saved darameter data from EEPROM
   // ----------------------------------------
-  
-  readUInt8TArrayFromEEPROM(1, parametersReflowREAD, 7);
-  for (i = 0; i < 7; i++) {
-    parametersReflow[i] = parametersReflowREAD[i];  // Need to cast the read INT values to double to retaing decimal places
-  }
-  readIntArrayFromEEPROM(8, parametersPIDREAD, 6);
-  // Convert INT PID Parameters from EEPROM memory to double and store them in variables used in program logic
-  for (i = 0; i < 6; i++) {
-    parametersPID[i] = (double)parametersPIDREAD[i] / 100;  // Need to cast the read INT values to double to retaing decimal places
-  }
-  
-  // ----------------------------------------
-  // Set up funcitons for the u8g2
-  // ----------------------------------------
-  delay(250);  // wait for the OLED to power up
-  u8g2.begin();
+  // Everything up to the display init runs while the OLED powers up
+  configLoad();
+  profileIndexLoad();
+  histFind();
 
   // ----------------------------------------
   // Initialization for PID Loops
@@ -1039,19 +3335,53 @@ void setup() {
 
   // Get initial temperature reading for display
   readThermistor();
+  T1Disp = steinhart1;
+  T2Disp = steinhart2;
+
+  // Offer to resume a reflow run interrupted by a reset - the heaters stay off until the operator decides
+  if (cpFind()) {
+    cpPending = 1;
+    menuIndex = MENU_RUN_INTERRUPTED;
+    menuCounter = 1;
+  }
+
+  uartBegin();                  // Telemetry, run history dump & diagnostics
+#ifdef PERF_STATS
+  perfFormatBenchmark();
+#endif
+
+  // ----------------------------------------
+  // Set up funcitons for the u8g2
+  // ----------------------------------------
+  while (millis() < OLED_POWERUP_MS) {   // wait out what is left of the OLED power-up time
+  }
+  u8g2.setBusClock(TWI_FREQ);  // Wire fallback - the interrupt driven transport always runs at TWI_FREQ
+  u8g2.initDisplay();          // No clearDisplay() as in begin() - the first frame rewrites every page anyway
+  u8g2.setPowerSave(0);
+  dispShown.menuIndex = 0xFF;    // Force the first frame to be drawn - sent by loop() one page / tile row per pass
+  bootReadyMs = millis();
 }
 
 void loop() {
+  eeWriterService();              // Completion callbacks of finished background EEPROM writes
+
   // ----------------------------------------
   // Rotary encoder handling
   // ----------------------------------------
 
-  // Poll the encoder pushbutton switch. Delay for minor debounce effect.
-  if (!digitalRead(encSW_inp)) {
-    encSW = 1;
-    delay(100);
-  } else {
-    encSW = 0;
+  // Encoder pushbutton - one debounced event per pass. A short press acts on release, a long press backs out instead.
+  encSW = 0;
+  switch (btnQueueGet()) {
+    case BTN_PRESS:
+      btnLongFired = 0;
+      break;
+    case BTN_LONG:
+      btnLongFired = 1;
+      menuBack();
+      break;
+    case BTN_RELEASE:
+      encSW = !btnLongFired;
+      break;
   }
 
   // Handle rotary encoder rotation
@@ -1065,32 +3395,97 @@ void loop() {
     calcParameters();
   }
 
-  // Display Handling
+  // Display Handling - repaint only when the render model changed, one page per loop pass
   updateCursorPosition();
+#ifdef PERF_STATS
+  unsigned long sliceStart = micros();
+  bool frameActive = displayBusy;
+  updateDisplay();
+  unsigned long sliceMicros = micros() - sliceStart;
+  if (frameActive || displayBusy) {
+    perfFrameMicros += sliceMicros;
+    perfSliceMaxMicros = max(perfSliceMaxMicros, sliceMicros);
+    if (displayBusy == 0) {
+      perfFrameCount++;
+    }
+  }
+#else
   updateDisplay();
+#endif
+  if (bootFirstFrameMs == 0 && displayBusy == 0 && dispShown.menuIndex != 0xFF) {
+    bootFirstFrameMs = millis();
+    uart.print(F("boot ms - ready: "));
+    uart.print(bootReadyMs);
+    uart.print(F("  first frame: "));
+    uart.println(bootFirstFrameMs);
+  }
 
-  // Initialize Running State to 1 (RAMP) when profile run is started
-  if (running == 1 && runningBuffer == 0) {   
+  // Initialize Running State to 1 (RAMP) when profile run is started (or the next batch cycle is started)
+  if ((running == 1 && runningBuffer == 0) || batchNextRequest) {   
+    batchNextRequest = 0;
     runningSecondCounter = 0;
+    runPeak1 = 0.0;
+    runPeak2 = 0.0;
     readThermistor();
     initTempSnapshot = (steinhart1 + steinhart2) / 2; // Capture initial temperature as average between the 2 thermistors
+    runStartTemp[0] = constrain(steinhart1, 0, 255);
+    runStartTemp[1] = constrain(steinhart2, 0, 255);
+    runTAL = 0;
+    runMaxDelta = 0;
+    historyLogged = 0;
+    batchCyclePass = 0;
+    coolRateMax = 0.0;
     runningState = 1;
+    if (runningMode == 1 && initTempSnapshot > RAMP_REF_TEMP) {
+      // Pre-warmed plates (standby / previous run): join the RAMP line, as designed from ambient, at the point matching the
+      // current plate temperature instead of re-ramping from t = 0. Plates already at or above T1 skip the RAMP entirely.
+      runningSecondCounter = rampStartSecond(initTempSnapshot);
+      initTempSnapshot = RAMP_REF_TEMP;
+    }
+    if (runningMode == 1) {
+      ilcStartRun();                                  // Load learned feedforward for this profile & clear run accumulators
+      graphStart();
+      modelPrevTemp[0] = 0.0;                         // No model rate sample until the first full second
+      modelPrevTemp[1] = 0.0;
+      plateUnsaturated = 0x03;
+    }
   }
 
+  // Warm standby when not running - hold the plates at the Standby SP between runs so the next profile starts pre-warmed,
+  // never while an interrupted run waits for RESUME / ABORT
+  if (!running && standbyAllowed(parametersProcess[1], thermistor1Fail || thermistor2Fail, menuIndex, cpPending)) {
+    readThermistor();
+    if(millis() - time_now > 1000){   // 1 Second timer - Update temperature display
+        time_now = millis();
+        T1Disp = steinhart1;
+        T2Disp = steinhart2;
+    }
+    pid_Setpoint = parametersProcess[1];
+    hotPlate1PID.SetMode(AUTOMATIC);
+    hotPlate2PID.SetMode(AUTOMATIC);
+    ilcFeedforward[0] = 0;
+    ilcFeedforward[1] = 0;
+    pidLoop1();
+    pidLoop2();
+    initTempSnapshot = 0;             // Clear / reset intial temp snapshot value
+  } else if (!running) {
   // Additional logic when not running - Force PID loops to Manual mode, read thermistor every 10 sec for 'Hot' menu display and thermistor fail check
-  if (!running) {
     
     pid_Setpoint = 0;                 // Force PID values to 0 / Manual & force a 0 output on PWM output pins
     hotPlate1PID.SetMode(MANUAL);
     hotPlate2PID.SetMode(MANUAL);
     pid1_Output = 0;
     pid2_Output = 0;
+    ilcFeedforward[0] = 0;
+    ilcFeedforward[1] = 0;
     analogWrite(pwmPin1, 0);
     analogWrite(pwmPin2, 0);
 
     if(millis() - time_now > 10000){   // 10 Second timer - Read thermistors every 10 sec when not running for 'HOT' menu display.
         time_now = millis();           // Also increment thermistor fail counters and set fail flag(s) if 3 identical readings are encountered
         readThermistor();
+        T1Disp = steinhart1;
+        T2Disp = steinhart2;
     }
     
     initTempSnapshot = 0;             // Clear / reset intial temp snapshot value
@@ -1103,6 +3498,18 @@ void loop() {
     constTempRunning();
   }
 
+  // Reflow run stopped by the operator before it completed
+  if (running == 0 && runningBuffer == 1 && runningMode == 1 && runningState < 6) {
+    histAppend(HIST_ABORTED);
+    cpWrite(0);
+  }
+
   // Buffer running flag
   runningBuffer = running;  
+
+  tlmService();
+
+#ifdef PERF_STATS
+  perfReport();
+#endif
 }
@@ -0,0 +1,14 @@
+#pragma once
+#include <stdint.h>
+
+// Warm standby interlock - kept free of hardware access so the native unit tests (test/) can check it.
+//
+// Between runs the plates are held at the Standby SP (0 = OFF), except with a failed thermistor or while an interrupted
+// run waits for the operator: on the Run Interrupted screen, or with its checkpoint not yet resolved, the heaters stay off
+// until RESUME or ABORT. Heating the plates there would also mask the drop below the checkpoint setpoint that the resume
+// check estimates the power-off time from, and let a stale run pass as resumable.
+#define MENU_RUN_INTERRUPTED 9      // menuIndex of the Run Interrupted (resume / abort) screen
+
+inline bool standbyAllowed(uint8_t standbySP, bool thermistorFail, uint8_t menuIndex, bool checkpointPending) {
+  return standbySP > 0 && !thermistorFail && menuIndex != MENU_RUN_INTERRUPTED && !checkpointPending;
+}
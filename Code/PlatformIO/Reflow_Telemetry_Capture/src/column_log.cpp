@@ -0,0 +1,226 @@
+#include "column_log.h"
+
+#include <cstring>
+
+#define COL_U8 1
+#define COL_U16 2
+#define COL_I16 3
+#define COL_U32 4
+
+struct Column {
+  uint8_t type;
+  const char *name;
+};
+
+// Column order of the log, one per Sample field (temperatures & setpoint in 0.1 C)
+static const Column columns[] = {
+  {COL_U32, "timestamp_ms"},
+  {COL_U8, "seq"},
+  {COL_U16, "adc1"},
+  {COL_U16, "adc2"},
+  {COL_I16, "temp1"},
+  {COL_I16, "temp2"},
+  {COL_I16, "setpoint"},
+  {COL_U8, "out1"},
+  {COL_U8, "out2"},
+  {COL_U8, "state"},
+  {COL_U8, "flags"},
+};
+static const size_t columnCount = sizeof(columns) / sizeof(columns[0]);
+
+// Field access by column index - keeps the writer & reader on the one column table
+static uint32_t getField(const Sample &s, size_t c) {
+  switch (c) {
+    case 0: return s.timestamp;
+    case 1: return s.sequence;
+    case 2: return s.adc[0];
+    case 3: return s.adc[1];
+    case 4: return (uint16_t)s.temp[0];
+    case 5: return (uint16_t)s.temp[1];
+    case 6: return (uint16_t)s.setpoint;
+    case 7: return s.output[0];
+    case 8: return s.output[1];
+    case 9: return s.state;
+    default: return s.flags;
+  }
+}
+
+static void setField(Sample &s, size_t c, uint32_t v) {
+  switch (c) {
+    case 0: s.timestamp = v; break;
+    case 1: s.sequence = v; break;
+    case 2: s.adc[0] = v; break;
+    case 3: s.adc[1] = v; break;
+    case 4: s.temp[0] = (int16_t)v; break;
+    case 5: s.temp[1] = (int16_t)v; break;
+    case 6: s.setpoint = (int16_t)v; break;
+    case 7: s.output[0] = v; break;
+    case 8: s.output[1] = v; break;
+    case 9: s.state = v; break;
+    default: s.flags = v; break;
+  }
+}
+
+static size_t typeSize(uint8_t type) {
+  return type == COL_U8 ? 1 : type == COL_U32 ? 4 : 2;
+}
+
+static void put(std::vector<uint8_t> &buffer, uint32_t v, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    buffer.push_back(v >> (8 * i));
+  }
+}
+
+static uint32_t get(const uint8_t *p, size_t size) {
+  uint32_t v = 0;
+  for (size_t i = 0; i < size; i++) {
+    v |= (uint32_t)p[i] << (8 * i);
+  }
+  return v;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Writer
+ColumnLogWriter::~ColumnLogWriter() {
+  close();
+}
+
+bool ColumnLogWriter::open(const std::string &path) {
+  std::vector<uint8_t> header;
+
+  file = fopen(path.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  header.insert(header.end(), {'R', 'H', 'T', 'L'});
+  put(header, LOG_VERSION, 2);
+  put(header, columnCount, 2);
+  for (const Column &c : columns) {
+    header.push_back(c.type);
+    header.push_back(strlen(c.name));
+    header.insert(header.end(), c.name, c.name + strlen(c.name));
+  }
+  block.reserve(LOG_BLOCK_ROWS);
+  return fwrite(header.data(), 1, header.size(), file) == header.size();
+}
+
+void ColumnLogWriter::append(const Sample &s) {
+  block.push_back(s);
+  rows++;
+  if (block.size() == LOG_BLOCK_ROWS) {
+    writeBlock();
+  }
+}
+
+void ColumnLogWriter::writeBlock() {
+  std::vector<uint8_t> buffer;
+
+  put(buffer, block.size(), 4);
+  for (size_t c = 0; c < columnCount; c++) {
+    for (const Sample &s : block) {
+      put(buffer, getField(s, c), typeSize(columns[c].type));
+    }
+  }
+  fwrite(buffer.data(), 1, buffer.size(), file);
+  fflush(file);                     // A killed capture loses at most the current block
+  block.clear();
+}
+
+bool ColumnLogWriter::close() {
+  bool ok;
+
+  if (!file) {
+    return true;
+  }
+  if (!block.empty()) {
+    writeBlock();
+  }
+  ok = !ferror(file);
+  ok = fclose(file) == 0 && ok;
+  file = nullptr;
+  return ok;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Reader
+ColumnLogReader::~ColumnLogReader() {
+  if (file) {
+    fclose(file);
+  }
+}
+
+bool ColumnLogReader::open(const std::string &path) {
+  uint8_t header[8];
+  uint8_t entry[2];
+  char name[256];
+
+  file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+  if (fread(header, 1, 8, file) != 8 || memcmp(header, "RHTL", 4) != 0 || get(header + 4, 2) != LOG_VERSION
+      || get(header + 6, 2) != columnCount) {
+    return false;
+  }
+  for (const Column &c : columns) {
+    if (fread(entry, 1, 2, file) != 2 || fread(name, 1, entry[1], file) != entry[1]) {
+      return false;
+    }
+    if (entry[0] != c.type || entry[1] != strlen(c.name) || memcmp(name, c.name, entry[1]) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ColumnLogReader::readBlock() {
+  uint8_t count[4];
+  std::vector<uint8_t> buffer;
+  uint32_t rowCount;
+
+  block.clear();
+  position = 0;
+  if (fread(count, 1, 4, file) != 4) {
+    return false;
+  }
+  rowCount = get(count, 4);
+  if (rowCount == 0 || rowCount > LOG_BLOCK_ROWS) {
+    error = true;
+    return false;
+  }
+  block.resize(rowCount);
+  for (size_t c = 0; c < columnCount; c++) {
+    size_t size = typeSize(columns[c].type);
+    buffer.resize(rowCount * size);
+    if (fread(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+      error = true;
+      return false;
+    }
+    for (uint32_t r = 0; r < rowCount; r++) {
+      setField(block[r], c, get(buffer.data() + r * size, size));
+    }
+  }
+  return true;
+}
+
+bool ColumnLogReader::next(Sample &s) {
+  if (position == block.size() && !readBlock()) {
+    return false;
+  }
+  s = block[position++];
+  return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// CSV export
+void csvHeader(FILE *out) {
+  fputs("timestamp_ms,seq,adc1,adc2,temp1_c,temp2_c,setpoint_c,out1,out2,state,running,reflow_mode,t1_fail,t2_fail\n",
+        out);
+}
+
+void csvRow(FILE *out, const Sample &s) {
+  fprintf(out, "%u,%u,%u,%u,%.1f,%.1f,%.1f,%u,%u,%u,%d,%d,%d,%d\n", s.timestamp, s.sequence, s.adc[0], s.adc[1],
+          s.temp[0] / 10.0, s.temp[1] / 10.0, s.setpoint / 10.0, s.output[0], s.output[1], s.state,
+          (s.flags & TLM_FLAG_RUNNING) != 0, (s.flags & TLM_FLAG_REFLOW) != 0, (s.flags & TLM_FLAG_T1_FAIL) != 0,
+          (s.flags & TLM_FLAG_T2_FAIL) != 0);
+}
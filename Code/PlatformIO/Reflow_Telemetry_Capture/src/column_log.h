@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "telemetry.h"
+
+// Columnar binary log (.rhtl) - samples are buffered in fixed size blocks and written column by column, so a
+// multi-hour capture never holds more than one block in memory and each column compresses / scans well.
+//
+//   Header: "RHTL"  u16 version  u16 columnCount  { u8 type  u8 nameLength  name } * columnCount
+//   Block:  u32 rowCount  { rowCount values of the column type } * columnCount      (all little endian)
+//
+// Column types: 1 u8, 2 u16, 3 i16, 4 u32
+#define LOG_VERSION 1
+#define LOG_BLOCK_ROWS 4096
+
+class ColumnLogWriter {
+ public:
+  ~ColumnLogWriter();
+  bool open(const std::string &path);
+  void append(const Sample &s);
+  bool close();                     // Flushes the last (partial) block
+
+  uint64_t rows = 0;
+
+ private:
+  FILE *file = nullptr;
+  std::vector<Sample> block;
+
+  void writeBlock();
+};
+
+class ColumnLogReader {
+ public:
+  ~ColumnLogReader();
+  bool open(const std::string &path);
+  bool next(Sample &s);             // false at end of log (or a truncated block)
+  bool error = false;
+
+ private:
+  FILE *file = nullptr;
+  std::vector<Sample> block;
+  size_t position = 0;
+
+  bool readBlock();
+};
+
+void csvHeader(FILE *out);
+void csvRow(FILE *out, const Sample &s);
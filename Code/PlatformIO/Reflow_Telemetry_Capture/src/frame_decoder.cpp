@@ -0,0 +1,104 @@
+#include "frame_decoder.h"
+
+#include <cctype>
+
+uint16_t crc16CcittFalse(const uint8_t *data, size_t length) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+size_t cobsDecode(const uint8_t *in, size_t length, uint8_t *out) {
+  size_t i = 0;
+  size_t o = 0;
+
+  while (i < length) {
+    uint8_t code = in[i++];
+    if (code == 0 || i + code - 1 > length) {
+      return 0;
+    }
+    for (uint8_t j = 1; j < code; j++) {
+      out[o++] = in[i++];
+    }
+    if (code < 0xFF && i < length) {
+      out[o++] = 0;
+    }
+  }
+  return o;
+}
+
+static uint16_t get16(const uint8_t *p) {
+  return p[0] | (p[1] << 8);
+}
+
+void FrameDecoder::feed(const uint8_t *data, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    if (data[i] == 0) {
+      segmentEnd();
+    } else if (segmentLength < MAX_SEGMENT) {
+      segment[segmentLength++] = data[i];
+    } else {                        // Over long segment - can only be text, pass on what is buffered
+      segmentEnd();
+      segment[segmentLength++] = data[i];
+    }
+  }
+}
+
+void FrameDecoder::flush() {
+  segmentEnd();
+}
+
+void FrameDecoder::segmentEnd() {
+  uint8_t raw[MAX_SEGMENT];
+  size_t length;
+  bool binary = false;
+
+  if (segmentLength == 0) {
+    return;
+  }
+  length = cobsDecode(segment, segmentLength, raw);
+  if (length == TLM_FRAME_SIZE + 2 && raw[0] == TLM_TYPE_SAMPLE) {
+    if (crc16CcittFalse(raw, TLM_FRAME_SIZE) == get16(raw + TLM_FRAME_SIZE)) {
+      Sample s;
+      s.sequence = raw[1];
+      s.timestamp = get16(raw + 2) | ((uint32_t)get16(raw + 4) << 16);
+      s.adc[0] = get16(raw + 6);
+      s.adc[1] = get16(raw + 8);
+      s.temp[0] = (int16_t)get16(raw + 10);
+      s.temp[1] = (int16_t)get16(raw + 12);
+      s.setpoint = (int16_t)get16(raw + 14);
+      s.output[0] = raw[16];
+      s.output[1] = raw[17];
+      s.state = raw[18];
+      s.flags = raw[19];
+      if (haveSequence) {
+        dropped += (uint8_t)(s.sequence - lastSequence - 1);
+      }
+      haveSequence = true;
+      lastSequence = s.sequence;
+      frames++;
+      if (onSample) {
+        onSample(s);
+      }
+      segmentLength = 0;
+      return;
+    }
+    binary = true;
+  }
+
+  // Not a frame - text if it is printable, otherwise a corrupted frame
+  for (size_t i = 0; i < segmentLength && !binary; i++) {
+    binary = !isprint(segment[i]) && !isspace(segment[i]);
+  }
+  if (binary) {
+    crcErrors++;
+  } else if (onText) {
+    onText(std::string((const char *)segment, segmentLength));
+  }
+  segmentLength = 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "telemetry.h"
+
+// Streaming decoder for the serial byte stream - splits it at the 0x00 frame delimiters, COBS decodes & CRC checks each
+// segment. Segments that are not valid frames are the controller's text output (history dump, reports) and are passed
+// on as text. Memory use is bounded by the longest segment kept (MAX_SEGMENT).
+class FrameDecoder {
+ public:
+  std::function<void(const Sample &)> onSample;
+  std::function<void(const std::string &)> onText;
+
+  void feed(const uint8_t *data, size_t length);
+  void flush();                     // End of stream - pass on a pending text segment
+
+  uint64_t frames = 0;              // Valid frames
+  uint64_t crcErrors = 0;           // Binary segments that failed the CRC
+  uint64_t dropped = 0;             // Frames missing from the sequence (skipped by the controller / lost)
+
+ private:
+  static const size_t MAX_SEGMENT = 512;
+  uint8_t segment[MAX_SEGMENT];
+  size_t segmentLength = 0;
+  bool haveSequence = false;
+  uint8_t lastSequence = 0;
+
+  void segmentEnd();
+};
+
+uint16_t crc16CcittFalse(const uint8_t *data, size_t length);
+size_t cobsDecode(const uint8_t *in, size_t length, uint8_t *out);   // 0 = invalid encoding
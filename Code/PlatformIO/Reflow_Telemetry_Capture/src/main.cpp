@@ -0,0 +1,231 @@
+/*
+Reflow Telemetry Capture - host side (Linux) companion to the Solder Reflow Hot Plate firmware.
+
+Captures the controller's binary telemetry stream (COBS framed, CRC checked samples interleaved with its text output) from
+the USB-UART serial port, stores it in a compact columnar log, exports it as CSV and reports per run metrics
+(overshoot, time above liquidus, setpoint tracking RMS). Everything is processed in a single streaming pass, so memory
+use stays constant for captures of any length.
+
+  reflow_capture capture <device | file | -> -o <log.rhtl> [--csv <out.csv>] [--liquidus <C>] [--quiet]
+  reflow_capture export <log.rhtl> <out.csv>
+  reflow_capture analyze <log.rhtl> [--liquidus <C>]
+*/
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "column_log.h"
+#include "frame_decoder.h"
+#include "run_metrics.h"
+#include "serial_port.h"
+
+static volatile sig_atomic_t stopRequest = 0;
+
+static void onSignal(int) {
+  stopRequest = 1;
+}
+
+static int usage() {
+  fprintf(stderr,
+          "usage: reflow_capture capture <device | file | -> -o <log.rhtl> [--csv <out.csv>] [--liquidus <C>] "
+          "[--quiet]\n"
+          "       reflow_capture export <log.rhtl> <out.csv>\n"
+          "       reflow_capture analyze <log.rhtl> [--liquidus <C>]\n");
+  return 2;
+}
+
+static void reportRun(const RunResult &r, void *context) {
+  printRun((FILE *)context, r);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// capture - serial stream -> log (+ CSV), run metrics reported live
+static int capture(int argc, char **argv) {
+  std::string source;
+  std::string logPath;
+  std::string csvPath;
+  std::string error;
+  double liquidus = DEFAULT_LIQUIDUS;
+  bool quiet = false;
+  SerialPort port;
+  ColumnLogWriter log;
+  FILE *csv = nullptr;
+  uint8_t buffer[4096];
+  long length;
+
+  for (int i = 0; i < argc; i++) {
+    if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+      logPath = argv[++i];
+    } else if (!strcmp(argv[i], "--csv") && i + 1 < argc) {
+      csvPath = argv[++i];
+    } else if (!strcmp(argv[i], "--liquidus") && i + 1 < argc) {
+      liquidus = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--quiet")) {
+      quiet = true;
+    } else if (source.empty()) {
+      source = argv[i];
+    } else {
+      return usage();
+    }
+  }
+  if (source.empty() || logPath.empty()) {
+    return usage();
+  }
+
+  if (!port.open(source, error)) {
+    fprintf(stderr, "%s: %s\n", source.c_str(), error.c_str());
+    return 1;
+  }
+  if (!log.open(logPath)) {
+    fprintf(stderr, "%s: %s\n", logPath.c_str(), strerror(errno));
+    return 1;
+  }
+  if (!csvPath.empty()) {
+    csv = fopen(csvPath.c_str(), "w");
+    if (!csv) {
+      fprintf(stderr, "%s: %s\n", csvPath.c_str(), strerror(errno));
+      return 1;
+    }
+    csvHeader(csv);
+  }
+
+  RunMetrics metrics(liquidus);
+  metrics.onRun = reportRun;
+  metrics.context = stdout;
+
+  FrameDecoder decoder;
+  decoder.onSample = [&](const Sample &s) {
+    log.append(s);
+    if (csv) {
+      csvRow(csv, s);
+    }
+    metrics.add(s);
+  };
+  decoder.onText = [&](const std::string &text) {   // Controller text output (history dump, boot / PERF reports)
+    if (!quiet) {
+      fwrite(text.data(), 1, text.size(), stderr);
+    }
+  };
+
+  // Ctrl-C ends the capture cleanly - no SA_RESTART, so the blocking read returns and the log is closed out
+  struct sigaction action = {};
+  action.sa_handler = onSignal;
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+
+  if (port.isTerminal()) {
+    fprintf(stderr, "capturing %s - Ctrl-C to stop\n", source.c_str());
+  }
+  while (!stopRequest) {
+    length = port.read(buffer, sizeof(buffer));
+    if (length > 0) {
+      decoder.feed(buffer, length);
+    } else if (length == 0 || errno != EINTR) {
+      break;
+    }
+  }
+  decoder.flush();
+  metrics.finish();
+
+  if (csv) {
+    fclose(csv);
+  }
+  if (!log.close()) {
+    fprintf(stderr, "%s: write failed\n", logPath.c_str());
+    return 1;
+  }
+  fprintf(stderr, "%llu frames (%llu dropped, %llu CRC errors), %u runs -> %s\n", (unsigned long long)decoder.frames,
+          (unsigned long long)decoder.dropped, (unsigned long long)decoder.crcErrors, metrics.runs, logPath.c_str());
+  return 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// export - log -> CSV
+static int exportCsv(int argc, char **argv) {
+  ColumnLogReader log;
+  FILE *csv;
+  Sample s;
+
+  if (argc != 2) {
+    return usage();
+  }
+  if (!log.open(argv[0])) {
+    fprintf(stderr, "%s: not a readable telemetry log\n", argv[0]);
+    return 1;
+  }
+  csv = fopen(argv[1], "w");
+  if (!csv) {
+    fprintf(stderr, "%s: %s\n", argv[1], strerror(errno));
+    return 1;
+  }
+  csvHeader(csv);
+  while (log.next(s)) {
+    csvRow(csv, s);
+  }
+  fclose(csv);
+  if (log.error) {
+    fprintf(stderr, "%s: truncated log, exported up to the last complete block\n", argv[0]);
+  }
+  return 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// analyze - log -> per run metrics
+static int analyze(int argc, char **argv) {
+  ColumnLogReader log;
+  double liquidus = DEFAULT_LIQUIDUS;
+  std::string path;
+  uint64_t frames = 0;
+  Sample s;
+
+  for (int i = 0; i < argc; i++) {
+    if (!strcmp(argv[i], "--liquidus") && i + 1 < argc) {
+      liquidus = atof(argv[++i]);
+    } else if (path.empty()) {
+      path = argv[i];
+    } else {
+      return usage();
+    }
+  }
+  if (path.empty()) {
+    return usage();
+  }
+  if (!log.open(path)) {
+    fprintf(stderr, "%s: not a readable telemetry log\n", path.c_str());
+    return 1;
+  }
+
+  RunMetrics metrics(liquidus);
+  metrics.onRun = reportRun;
+  metrics.context = stdout;
+  while (log.next(s)) {
+    metrics.add(s);
+    frames++;
+  }
+  metrics.finish();
+  printf("%llu frames, %u runs (liquidus %.1f C)\n", (unsigned long long)frames, metrics.runs, liquidus);
+  if (log.error) {
+    fprintf(stderr, "%s: truncated log, analysed up to the last complete block\n", path.c_str());
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    return usage();
+  }
+  if (!strcmp(argv[1], "capture")) {
+    return capture(argc - 2, argv + 2);
+  }
+  if (!strcmp(argv[1], "export")) {
+    return exportCsv(argc - 2, argv + 2);
+  }
+  if (!strcmp(argv[1], "analyze")) {
+    return analyze(argc - 2, argv + 2);
+  }
+  return usage();
+}
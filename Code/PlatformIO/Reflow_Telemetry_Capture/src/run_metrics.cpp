@@ -0,0 +1,107 @@
+#include "run_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+void RunMetrics::start(const Sample &s) {
+  active = true;
+  run = RunResult();
+  run.number = ++runs;
+  run.reflowMode = s.flags & TLM_FLAG_REFLOW;
+  run.startMs = s.timestamp;
+  run.peak[0] = run.peak[1] = -1000.0;
+  run.maxSetpoint = -1000.0;
+  squaredError[0] = squaredError[1] = 0.0;
+  trackingFrames = 0;
+  lastMs = s.timestamp;
+  lastAboveLiquidus = false;
+}
+
+void RunMetrics::end(bool complete) {
+  active = false;
+  run.complete = complete;
+  run.durationMs = lastMs - run.startMs;
+  run.overshoot = std::max(0.0, std::max(run.peak[0], run.peak[1]) - run.maxSetpoint);
+  for (int i = 0; i < 2; i++) {
+    run.rms[i] = trackingFrames ? std::sqrt(squaredError[i] / trackingFrames) : 0.0;
+  }
+  if (onRun) {
+    onRun(run, context);
+  }
+}
+
+void RunMetrics::add(const Sample &s) {
+  bool running = s.flags & TLM_FLAG_RUNNING;
+  bool reflow = s.flags & TLM_FLAG_REFLOW;
+  uint8_t state = reflow ? s.state : 0;   // Const temp frames carry no profile state (older firmware sent a stale one)
+  double t1 = s.temp[0] / 10.0;
+  double t2 = s.temp[1] / 10.0;
+  double setpoint = s.setpoint / 10.0;
+
+  if (!active) {
+    if (!running || state == 6) {
+      return;
+    }
+    start(s);
+  } else if (!running) {
+    end(false);
+    return;
+  } else if (reflow != run.reflowMode) {   // The stop frame between two runs was lost
+    end(false);
+    start(s);
+  }
+
+  // TAL integrates the frame intervals (the controller may skip frames), credited where the previous frame was above
+  if (lastAboveLiquidus) {
+    run.tal += (uint32_t)(s.timestamp - lastMs) / 1000.0;
+  }
+  lastAboveLiquidus = t1 >= liquidus && t2 >= liquidus;
+  lastMs = s.timestamp;
+  run.frames++;
+  if (s.flags & (TLM_FLAG_T1_FAIL | TLM_FLAG_T2_FAIL)) {
+    run.thermistorFails++;
+  }
+
+  if (!reflow) {                    // Const temp - the whole run holds the setpoint, including the warm up
+    run.peak[0] = std::max(run.peak[0], t1);
+    run.peak[1] = std::max(run.peak[1], t2);
+    run.maxSetpoint = std::max(run.maxSetpoint, setpoint);
+  } else if (state >= 1 && state <= 4) {
+    run.peak[0] = std::max(run.peak[0], t1);
+    run.peak[1] = std::max(run.peak[1], t2);
+    run.maxSetpoint = std::max(run.maxSetpoint, setpoint);
+    squaredError[0] += (t1 - setpoint) * (t1 - setpoint);
+    squaredError[1] += (t2 - setpoint) * (t2 - setpoint);
+    trackingFrames++;
+  } else if (state == 5) {        // COOLING - overshoot past the reflow peak is carried into the first cooling seconds
+    run.peak[0] = std::max(run.peak[0], t1);
+    run.peak[1] = std::max(run.peak[1], t2);
+  } else if (state == 6) {
+    end(true);
+  }
+}
+
+void RunMetrics::finish() {
+  if (active) {
+    end(false);
+  }
+}
+
+void printRun(FILE *out, const RunResult &r) {
+  fprintf(out, "run %u  %s  start %.1f s  duration %.1f s  frames %llu  %s\n", r.number,
+          r.reflowMode ? "REFLOW" : "CONST TEMP", r.startMs / 1000.0, r.durationMs / 1000.0,
+          (unsigned long long)r.frames, r.complete ? "COMPLETE" : r.reflowMode ? "ABORTED" : "STOPPED");
+  if (r.maxSetpoint < -999.0) {
+    return;
+  }
+  fprintf(out, "  peak T1 %.1f C  T2 %.1f C  max setpoint %.1f C  overshoot %.1f C\n", r.peak[0], r.peak[1],
+          r.maxSetpoint, r.overshoot);
+  fprintf(out, "  TAL %.1f s", r.tal);
+  if (r.reflowMode) {
+    fprintf(out, "  tracking RMS T1 %.2f C  T2 %.2f C", r.rms[0], r.rms[1]);
+  }
+  if (r.thermistorFails) {
+    fprintf(out, "  thermistor fault frames %u", r.thermistorFails);
+  }
+  fputc('\n', out);
+}
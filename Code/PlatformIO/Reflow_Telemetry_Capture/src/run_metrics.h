@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+
+#include "telemetry.h"
+
+#define DEFAULT_LIQUIDUS 138.0      // Sn42/Bi58 low temp paste (C)
+
+// Per run result - a run spans the frames from the running flag rising to it falling (or state 6 COMPLETE). States are
+// only read from reflow profile mode frames; a constant temp run ends when it is stopped
+struct RunResult {
+  uint32_t number;
+  bool reflowMode;
+  uint32_t startMs;
+  uint32_t durationMs;
+  uint64_t frames;
+  double peak[2];                   // Peak plate temperatures (C)
+  double maxSetpoint;
+  double overshoot;                 // Peak above the highest setpoint of the run (C), 0 if none
+  double tal;                       // Time both plates were at / above liquidus (s)
+  double rms[2];                    // Setpoint tracking RMS error over the heating states 1 - 4 (C), reflow runs only
+  uint32_t thermistorFails;         // Frames flagging a thermistor fault
+  bool complete;                    // Reached state 6 COMPLETE (else aborted / capture ended)
+};
+
+// Single pass, constant memory run metrics - feed every sample in capture order, results are reported as each run ends
+class RunMetrics {
+ public:
+  explicit RunMetrics(double liquidus) : liquidus(liquidus) {}
+  void add(const Sample &s);
+  void finish();                    // End of capture - close a run still in progress
+
+  void (*onRun)(const RunResult &r, void *context) = nullptr;
+  void *context = nullptr;
+  uint32_t runs = 0;
+
+ private:
+  double liquidus;
+  bool active = false;
+  uint32_t lastMs = 0;
+  bool lastAboveLiquidus = false;
+  double squaredError[2];
+  uint64_t trackingFrames;
+  RunResult run;
+
+  void start(const Sample &s);
+  void end(bool complete);
+};
+
+void printRun(FILE *out, const RunResult &r);
@@ -0,0 +1,49 @@
+#include "serial_port.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+SerialPort::~SerialPort() {
+  if (fd > 0) {
+    close(fd);
+  }
+}
+
+bool SerialPort::open(const std::string &path, std::string &error) {
+  struct termios tty;
+
+  fd = path == "-" ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY | O_NOCTTY);
+  if (fd < 0) {
+    error = strerror(errno);
+    return false;
+  }
+  terminal = isatty(fd);
+  if (!terminal) {
+    return true;
+  }
+
+  if (tcgetattr(fd, &tty) != 0) {
+    error = strerror(errno);
+    return false;
+  }
+  cfmakeraw(&tty);
+  cfsetispeed(&tty, B115200);
+  cfsetospeed(&tty, B115200);
+  tty.c_cflag |= CLOCAL | CREAD;
+  tty.c_cflag &= ~(CSTOPB | CRTSCTS);
+  tty.c_cc[VMIN] = 1;                // Block until data arrives
+  tty.c_cc[VTIME] = 0;
+  if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+    error = strerror(errno);
+    return false;
+  }
+  tcflush(fd, TCIFLUSH);             // Drop anything buffered before the capture started
+  return true;
+}
+
+long SerialPort::read(uint8_t *buffer, size_t length) {
+  return ::read(fd, buffer, length);
+}
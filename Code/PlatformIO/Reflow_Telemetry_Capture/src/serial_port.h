@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Telemetry source - a serial device (set raw 115200 8N1, as the controller's UART) or any other file / pty / pipe,
+// read as is. "-" reads standard input.
+class SerialPort {
+ public:
+  ~SerialPort();
+  bool open(const std::string &path, std::string &error);
+  long read(uint8_t *buffer, size_t length);   // Bytes read, 0 at end of file, -1 on error / interrupted
+  bool isTerminal() const { return terminal; }
+
+ private:
+  int fd = -1;
+  bool terminal = false;
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+
+// Telemetry sample as sent by the controller (TelemetryFrame in the firmware) - decoded, host byte order
+#define TLM_TYPE_SAMPLE 1
+#define TLM_FRAME_SIZE 20           // Payload bytes, followed by a CRC-16/CCITT-FALSE (little endian)
+
+#define TLM_FLAG_RUNNING 0x01
+#define TLM_FLAG_REFLOW 0x02        // Reflow profile mode (else constant temp mode)
+#define TLM_FLAG_T1_FAIL 0x04
+#define TLM_FLAG_T2_FAIL 0x08
+
+struct Sample {
+  uint32_t timestamp;               // Controller millis()
+  uint8_t sequence;
+  uint16_t adc[2];                  // Raw thermistor ADC counts
+  int16_t temp[2];                  // Plate temperatures (0.1 C)
+  int16_t setpoint;                 // PID setpoint (0.1 C)
+  uint8_t output[2];                // Heater outputs (PWM counts)
+  uint8_t state;                    // runningState: 1 RAMP, 2 SOAK, 3 REFLOW RAMP, 4 REFLOW, 5 COOLING, 6 COMPLETE
+                                    // (0 in constant temp mode)
+  uint8_t flags;                    // TLM_FLAG_
+};
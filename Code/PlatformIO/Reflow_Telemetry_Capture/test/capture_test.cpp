@@ -0,0 +1,276 @@
+/*
+Regression tests for the capture pipeline - frame decoding, the columnar log and the run metrics - run against the
+synthetic stream in test/data (see fixture.h).
+
+  capture_test <two_runs.bin>
+  capture_test --write-fixture <two_runs.bin>       Regenerate the fixture after changing fixture.cpp
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "column_log.h"
+#include "fixture.h"
+#include "frame_decoder.h"
+#include "run_metrics.h"
+
+static int failures = 0;
+
+#define CHECK(condition)                                                   \
+  do {                                                                     \
+    if (!(condition)) {                                                    \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+#define CHECK_NEAR(a, b) CHECK(std::fabs((a) - (b)) < 0.005)
+
+static std::vector<uint8_t> fixture;
+
+static bool readFile(const std::string &path, std::vector<uint8_t> &data) {
+  FILE *file = fopen(path.c_str(), "rb");
+  uint8_t buffer[4096];
+  size_t length;
+
+  if (!file) {
+    return false;
+  }
+  data.clear();
+  while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    data.insert(data.end(), buffer, buffer + length);
+  }
+  fclose(file);
+  return true;
+}
+
+static bool sameSample(const Sample &a, const Sample &b) {
+  return a.timestamp == b.timestamp && a.sequence == b.sequence && a.adc[0] == b.adc[0] && a.adc[1] == b.adc[1]
+      && a.temp[0] == b.temp[0] && a.temp[1] == b.temp[1] && a.setpoint == b.setpoint && a.output[0] == b.output[0]
+      && a.output[1] == b.output[1] && a.state == b.state && a.flags == b.flags;
+}
+
+static Sample testSample(uint32_t i) {
+  Sample s;
+
+  s.timestamp = 0x00FF0000 + 200 * i;   // Zero bytes inside the frame exercise the COBS code blocks
+  s.sequence = i;
+  s.adc[0] = 512;
+  s.adc[1] = 0;
+  s.temp[0] = -15;
+  s.temp[1] = 2355;
+  s.setpoint = 1850;
+  s.output[0] = 255;
+  s.output[1] = 0;
+  s.state = 3;
+  s.flags = TLM_FLAG_RUNNING | TLM_FLAG_REFLOW | TLM_FLAG_T2_FAIL;
+  return s;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+static void testCrcCobs() {
+  const uint8_t check[] = "123456789";
+  const uint8_t encoded[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+  const uint8_t overrun[] = {0x05, 0x11, 0x22};
+  const uint8_t zeroCode[] = {0x02, 0x11, 0x00, 0x22};
+  uint8_t decoded[8];
+  std::vector<uint8_t> stream;
+  std::vector<Sample> samples;
+  FrameDecoder decoder;
+
+  CHECK(crc16CcittFalse(check, 9) == 0x29B1);
+  CHECK(cobsDecode(encoded, sizeof(encoded), decoded) == 4);
+  CHECK(decoded[0] == 0x11 && decoded[1] == 0x22 && decoded[2] == 0x00 && decoded[3] == 0x33);
+  CHECK(cobsDecode(overrun, sizeof(overrun), decoded) == 0);
+  CHECK(cobsDecode(zeroCode, sizeof(zeroCode), decoded) == 0);
+
+  // Round trip, then the same frame with a flipped bit - counted as a CRC error, never passed on as text
+  encodeFrame(testSample(7), false, stream);
+  encodeFrame(testSample(8), true, stream);
+  decoder.onSample = [&](const Sample &s) { samples.push_back(s); };
+  decoder.onText = [&](const std::string &) { CHECK(false); };
+  decoder.feed(stream.data(), stream.size());
+  decoder.flush();
+  CHECK(decoder.frames == 1);
+  CHECK(decoder.crcErrors == 1);
+  CHECK(samples.size() == 1 && sameSample(samples[0], testSample(7)));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+static void testFixtureStream() {
+  std::string text;
+  FrameDecoder decoder;
+  uint8_t lastSequence = 0;
+  bool wrapped = false;
+
+  CHECK(buildFixture() == fixture);   // The committed stream is the one fixture.cpp describes
+
+  decoder.onSample = [&](const Sample &s) {
+    wrapped = wrapped || s.sequence < lastSequence;
+    lastSequence = s.sequence;
+  };
+  decoder.onText = [&](const std::string &t) { text += t; };
+  for (size_t i = 0; i < fixture.size(); i += 7) {   // Odd sized reads split frames across feed() calls
+    decoder.feed(fixture.data() + i, std::min<size_t>(7, fixture.size() - i));
+  }
+  decoder.flush();
+  CHECK(decoder.frames == FIXTURE_FRAMES);
+  CHECK(decoder.dropped == FIXTURE_DROPPED);
+  CHECK(decoder.crcErrors == FIXTURE_CRC_ERRORS);
+  CHECK(text == FIXTURE_BOOT_TEXT FIXTURE_HISTORY_TEXT);
+  CHECK(wrapped);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// The CSV written live by capture must match the one export produces from the log
+static void testCsvRoundTrip() {
+  ColumnLogWriter writer;
+  ColumnLogReader reader;
+  FrameDecoder decoder;
+  std::vector<uint8_t> captured, exported;
+  FILE *csv;
+  Sample s;
+
+  CHECK(writer.open("roundtrip.rhtl"));
+  csv = fopen("roundtrip_capture.csv", "w");
+  csvHeader(csv);
+  decoder.onSample = [&](const Sample &s) {
+    writer.append(s);
+    csvRow(csv, s);
+  };
+  decoder.feed(fixture.data(), fixture.size());
+  decoder.flush();
+  fclose(csv);
+  CHECK(writer.close());
+  CHECK(writer.rows == FIXTURE_FRAMES);
+
+  CHECK(reader.open("roundtrip.rhtl"));
+  csv = fopen("roundtrip_export.csv", "w");
+  csvHeader(csv);
+  while (reader.next(s)) {
+    csvRow(csv, s);
+  }
+  fclose(csv);
+  CHECK(!reader.error);
+
+  CHECK(readFile("roundtrip_capture.csv", captured));
+  CHECK(readFile("roundtrip_export.csv", exported));
+  CHECK(!captured.empty() && captured == exported);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// A killed capture leaves a partial last block - the reader stops at the last complete one and flags it
+static void testTruncatedLog() {
+  const uint32_t rows = LOG_BLOCK_ROWS + 1000;
+  ColumnLogWriter writer;
+  Sample s;
+  uint32_t read = 0;
+  bool match = true;
+
+  CHECK(writer.open("truncated.rhtl"));
+  for (uint32_t i = 0; i < rows; i++) {
+    writer.append(testSample(i));
+  }
+  CHECK(writer.close());
+  std::filesystem::resize_file("truncated.rhtl", std::filesystem::file_size("truncated.rhtl") - 100);
+
+  ColumnLogReader reader;
+  CHECK(reader.open("truncated.rhtl"));
+  while (reader.next(s)) {
+    match = match && sameSample(s, testSample(read));
+    read++;
+  }
+  CHECK(read == LOG_BLOCK_ROWS);
+  CHECK(match);
+  CHECK(reader.error);
+
+  std::filesystem::resize_file("truncated.rhtl", 10);   // Cut inside the header - not a readable log
+  ColumnLogReader header;
+  CHECK(!header.open("truncated.rhtl"));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+static void collectRun(const RunResult &r, void *context) {
+  ((std::vector<RunResult> *)context)->push_back(r);
+}
+
+static void testRunMetrics() {
+  std::vector<RunResult> runs;
+  RunMetrics metrics(DEFAULT_LIQUIDUS);
+  FrameDecoder decoder;
+
+  metrics.onRun = collectRun;
+  metrics.context = &runs;
+  decoder.onSample = [&](const Sample &s) { metrics.add(s); };
+  decoder.feed(fixture.data(), fixture.size());
+  decoder.flush();
+  metrics.finish();
+
+  CHECK(runs.size() == 3);
+  if (runs.size() != 3) {
+    return;
+  }
+  CHECK(runs[0].number == 1 && runs[0].reflowMode && runs[0].complete);
+  CHECK(runs[0].frames == 290);
+  CHECK(runs[0].durationMs == 290000);
+  CHECK_NEAR(runs[0].maxSetpoint, 185.0);
+  CHECK_NEAR(runs[0].peak[0], 189.0);
+  CHECK_NEAR(runs[0].overshoot, 4.0);
+  CHECK_NEAR(runs[0].tal, 126.0);
+  CHECK_NEAR(runs[0].rms[0], 1.0);
+  CHECK_NEAR(runs[0].rms[1], 2.0);
+  CHECK(runs[0].thermistorFails == 0);
+
+  CHECK(runs[1].number == 2 && runs[1].reflowMode && !runs[1].complete);
+  CHECK(runs[1].frames == 177);
+  CHECK(runs[1].durationMs == 179000);
+  CHECK_NEAR(runs[1].maxSetpoint, 170.3);
+  CHECK_NEAR(runs[1].overshoot, 1.0);
+  CHECK_NEAR(runs[1].tal, 41.0);
+  CHECK_NEAR(runs[1].rms[0], 1.0);
+  CHECK_NEAR(runs[1].rms[1], 2.0);
+
+  // Const temp - the stale state must neither start reflow scoring nor end the run
+  CHECK(runs[2].number == 3 && !runs[2].reflowMode && !runs[2].complete);
+  CHECK(runs[2].frames == 60);
+  CHECK(runs[2].durationMs == 59000);
+  CHECK_NEAR(runs[2].maxSetpoint, 150.0);
+  CHECK_NEAR(runs[2].peak[0], 153.0);
+  CHECK_NEAR(runs[2].peak[1], 151.0);
+  CHECK_NEAR(runs[2].overshoot, 3.0);
+  CHECK_NEAR(runs[2].tal, 32.0);
+  CHECK_NEAR(runs[2].rms[0], 0.0);
+}
+
+int main(int argc, char **argv) {
+  if (argc == 3 && !strcmp(argv[1], "--write-fixture")) {
+    std::vector<uint8_t> data = buildFixture();
+    FILE *file = fopen(argv[2], "wb");
+    if (!file || fwrite(data.data(), 1, data.size(), file) != data.size() || fclose(file) != 0) {
+      perror(argv[2]);
+      return 1;
+    }
+    return 0;
+  }
+  if (argc != 2 || !readFile(argv[1], fixture)) {
+    fprintf(stderr, "usage: capture_test <two_runs.bin> | --write-fixture <two_runs.bin>\n");
+    return 2;
+  }
+
+  testCrcCobs();
+  testFixtureStream();
+  testCsvRoundTrip();
+  testTruncatedLog();
+  testRunMetrics();
+
+  if (failures) {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
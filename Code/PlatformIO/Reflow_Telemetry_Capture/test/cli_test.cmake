@@ -0,0 +1,38 @@
+# End to end run of the tool on the fixture - capture (log + live CSV), export and analyze
+#   cmake -DTOOL=<reflow_capture> -DFIXTURE=<two_runs.bin> -P cli_test.cmake
+
+function(run_tool output)
+  execute_process(COMMAND ${TOOL} ${ARGN} RESULT_VARIABLE result OUTPUT_VARIABLE out ERROR_VARIABLE err)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "reflow_capture ${ARGN} failed (${result}):\n${out}${err}")
+  endif()
+  set(${output} "${out}${err}" PARENT_SCOPE)
+endfunction()
+
+function(expect text pattern)
+  string(FIND "${text}" "${pattern}" position)
+  if(position EQUAL -1)
+    message(FATAL_ERROR "expected \"${pattern}\" in:\n${text}")
+  endif()
+endfunction()
+
+file(REMOVE cli.rhtl cli_capture.csv cli_export.csv)
+
+run_tool(out capture ${FIXTURE} -o cli.rhtl --csv cli_capture.csv --quiet)
+expect("${out}" "573 frames (5 dropped, 1 CRC errors), 3 runs")
+expect("${out}" "run 1  REFLOW  start 5.3 s  duration 290.0 s  frames 290  COMPLETE")
+expect("${out}" "run 2  REFLOW  start 316.3 s  duration 179.0 s  frames 177  ABORTED")
+expect("${out}" "run 3  CONST TEMP  start 507.3 s  duration 59.0 s  frames 60  STOPPED")
+
+run_tool(out export cli.rhtl cli_export.csv)
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files cli_capture.csv cli_export.csv RESULT_VARIABLE different)
+if(different)
+  message(FATAL_ERROR "capture CSV and export CSV differ")
+endif()
+
+run_tool(out analyze cli.rhtl)
+expect("${out}" "overshoot 4.0 C")
+expect("${out}" "TAL 126.0 s  tracking RMS T1 1.00 C  T2 2.00 C")
+expect("${out}" "TAL 41.0 s")
+expect("${out}" "overshoot 3.0 C\n  TAL 32.0 s\n")
+expect("${out}" "573 frames, 3 runs (liquidus 138.0 C)")
@@ -0,0 +1,159 @@
+#include "fixture.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "frame_decoder.h"
+
+static void put16(uint8_t *p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+// Same encoder as cobsEncode() in the firmware - frames are shorter than 254 bytes, so no 0xFF code blocks
+static size_t cobsEncode(const uint8_t *in, size_t length, uint8_t *out) {
+  uint8_t code = 1;
+  size_t codeIndex = 0;
+  size_t o = 1;
+
+  for (size_t i = 0; i < length; i++) {
+    if (in[i] == 0) {
+      out[codeIndex] = code;
+      codeIndex = o++;
+      code = 1;
+    } else {
+      out[o++] = in[i];
+      code++;
+    }
+  }
+  out[codeIndex] = code;
+  return o;
+}
+
+// Packs the sample as TelemetryFrame - corrupt flips a payload bit after the CRC is taken
+void encodeFrame(const Sample &s, bool corrupt, std::vector<uint8_t> &out) {
+  uint8_t raw[TLM_FRAME_SIZE + 2];
+  uint8_t encoded[sizeof(raw) + 2];
+  size_t n;
+
+  raw[0] = TLM_TYPE_SAMPLE;
+  raw[1] = s.sequence;
+  put16(raw + 2, s.timestamp & 0xFFFF);
+  put16(raw + 4, s.timestamp >> 16);
+  put16(raw + 6, s.adc[0]);
+  put16(raw + 8, s.adc[1]);
+  put16(raw + 10, s.temp[0]);
+  put16(raw + 12, s.temp[1]);
+  put16(raw + 14, s.setpoint);
+  raw[16] = s.output[0];
+  raw[17] = s.output[1];
+  raw[18] = s.state;
+  raw[19] = s.flags;
+  put16(raw + TLM_FRAME_SIZE, crc16CcittFalse(raw, TLM_FRAME_SIZE));
+  if (corrupt) {
+    raw[10] ^= 0x01;
+  }
+
+  n = cobsEncode(raw, sizeof(raw), encoded);
+  out.push_back(0);
+  out.insert(out.end(), encoded, encoded + n);
+  out.push_back(0);
+}
+
+// Reflow profile setpoint (0.1 C) and state for second i of a run
+static void profilePoint(int i, int16_t &setpoint, uint8_t &state) {
+  if (i < 100) {
+    setpoint = 250 + 10 * i, state = 1;
+  } else if (i < 150) {
+    setpoint = 1250 + 4 * (i - 100), state = 2;
+  } else if (i < 200) {
+    setpoint = 1500 + 7 * (i - 150), state = 3;
+  } else if (i < 240) {
+    setpoint = 1850, state = 4;
+  } else if (i < 290) {
+    setpoint = 1850 - 20 * (i - 240), state = 5;
+  } else {
+    setpoint = 850, state = 6;
+  }
+}
+
+struct StreamBuilder {
+  std::vector<uint8_t> out;
+  uint32_t slot = 0;
+  uint8_t sequence = 200;           // Wraps early in the stream
+  uint8_t mode = TLM_FLAG_REFLOW;   // runningMode of the controller
+
+  // One telemetry period - the frame consumes its sequence number even when it never arrives
+  void frame(int16_t temp1, int16_t temp2, int16_t setpoint, uint8_t state, bool running, bool lost = false,
+             bool corrupt = false) {
+    Sample s;
+
+    s.timestamp = 300 + 1000 * slot++;
+    s.sequence = sequence++;
+    s.adc[0] = 900 - temp1 / 4;
+    s.adc[1] = 900 - temp2 / 4;
+    s.temp[0] = temp1;
+    s.temp[1] = temp2;
+    s.setpoint = setpoint;
+    s.output[0] = running ? 180 : 0;
+    s.output[1] = running ? 170 : 0;
+    s.state = state;
+    s.flags = (running ? TLM_FLAG_RUNNING : 0) | mode;
+    if (!lost) {
+      encodeFrame(s, corrupt, out);
+    }
+  }
+
+  void idle(int count, int corruptAt = -1) {
+    for (int i = 0; i < count; i++) {
+      frame(235, 230, 0, 0, false, false, i == corruptAt);
+    }
+  }
+
+  void text(const char *text) {
+    out.insert(out.end(), text, text + strlen(text));
+  }
+
+  // Reflow run for seconds 0 - last, STOPped at last + 1 when that is before COMPLETE
+  void run(int last, int lostFrom, int lostTo) {
+    int16_t setpoint;
+    uint8_t state;
+
+    for (int i = 0; i <= last; i++) {
+      profilePoint(i, setpoint, state);
+      if (state == 5) {
+        frame(setpoint + (i == 240 ? 40 : 0), setpoint, setpoint, state, true, i >= lostFrom && i <= lostTo);
+      } else {
+        frame(setpoint + 10, setpoint - 20, setpoint, state, true, i >= lostFrom && i <= lostTo);
+      }
+    }
+    if (state != 6) {
+      frame(setpoint + 10, setpoint - 20, 0, state, false);
+    }
+  }
+
+  // Constant temp run at 150.0 C for seconds 0 - last, then STOPped. Older firmware sent the state left over from the
+  // last reflow run in these frames, so they carry that instead of 0
+  void constTemp(int last, uint8_t staleState) {
+    mode = 0;
+    for (int i = 0; i <= last; i++) {
+      frame(std::min(300 + 40 * i, 1530), std::min(300 + 40 * i, 1510), 1500, staleState, true);
+    }
+    frame(1530, 1510, 0, staleState, false);
+  }
+};
+
+std::vector<uint8_t> buildFixture() {
+  StreamBuilder b;
+
+  b.idle(5);
+  b.text(FIXTURE_BOOT_TEXT);
+  b.run(290, 10, 10);
+  b.idle(20, 7);
+  b.text(FIXTURE_HISTORY_TEXT);
+  b.run(179, 50, 52);
+  b.idle(10);
+  b.constTemp(59, 3);
+  b.idle(10);
+  return b.out;
+}
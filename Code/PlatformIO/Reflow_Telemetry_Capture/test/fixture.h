@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "telemetry.h"
+
+// Synthetic controller stream (test/data/two_runs.bin) - telemetry frames encoded the way the firmware sends them
+// (0x00, COBS(frame + CRC), 0x00) with its text output in between, one frame per second:
+//
+//   idle x5, boot text, run 1 (reaches COMPLETE), idle x20 (one frame corrupted), history text, run 2 (STOPped in
+//   REFLOW RAMP), idle x10, run 3 (constant temp, STOPped), idle x10
+//
+// Run 1 loses frame 10 and run 2 frames 50 - 52, so with the corrupted frame 5 sequence numbers are missing. Plate 1
+// tracks the setpoint +1.0 C and plate 2 -2.0 C through states 1 - 4; in COOLING plate 2 sits on the setpoint and plate
+// 1 peaks 4.0 C over the reflow setpoint on the first cooling second. Run 3 warms both plates 4.0 C/s to 153.0 / 151.0 C
+// against a 150.0 C setpoint, its frames carrying run 2's stale REFLOW RAMP state. At the default 138 C liquidus:
+//
+//   run 1: 290 frames, 290.0 s, COMPLETE, overshoot 4.0 C, TAL 126.0 s, RMS 1.00 / 2.00 C
+//   run 2: 177 frames, 179.0 s, ABORTED,  overshoot 1.0 C, TAL  41.0 s, RMS 1.00 / 2.00 C
+//   run 3:  60 frames,  59.0 s, STOPPED,  overshoot 3.0 C, TAL  32.0 s
+#define FIXTURE_FRAMES 573
+#define FIXTURE_DROPPED 5
+#define FIXTURE_CRC_ERRORS 1
+#define FIXTURE_BOOT_TEXT "boot ms - ready: 12  first frame: 300\r\n"
+#define FIXTURE_HISTORY_TEXT "run,slot,peak1,peak2,tal,batch,coolmax\r\n1,0,189,185,126,0,2.0\r\n"
+
+std::vector<uint8_t> buildFixture();
+void encodeFrame(const Sample &s, bool corrupt, std::vector<uint8_t> &out);
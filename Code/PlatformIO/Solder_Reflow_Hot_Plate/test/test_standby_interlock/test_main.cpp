@@ -0,0 +1,40 @@
+// Native unit tests of the warm standby interlock - pio test -e native
+#include <unity.h>
+
+#include "standby_interlock.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_standby_holds_between_runs() {
+  TEST_ASSERT_TRUE(standbyAllowed(100, false, 0, false));
+  TEST_ASSERT_TRUE(standbyAllowed(100, false, 6, false));
+}
+
+void test_standby_off() {
+  TEST_ASSERT_FALSE(standbyAllowed(0, false, 0, false));
+}
+
+void test_thermistor_fail_blocks_standby() {
+  TEST_ASSERT_FALSE(standbyAllowed(100, true, 0, false));
+}
+
+void test_run_interrupted_screen_blocks_standby() {
+  TEST_ASSERT_FALSE(standbyAllowed(100, false, MENU_RUN_INTERRUPTED, false));
+  TEST_ASSERT_FALSE(standbyAllowed(100, false, MENU_RUN_INTERRUPTED, true));
+}
+
+void test_pending_checkpoint_blocks_standby() {
+  TEST_ASSERT_FALSE(standbyAllowed(100, false, 0, true));
+  TEST_ASSERT_FALSE(standbyAllowed(150, false, 2, true));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_standby_holds_between_runs);
+  RUN_TEST(test_standby_off);
+  RUN_TEST(test_thermistor_fail_blocks_standby);
+  RUN_TEST(test_run_interrupted_screen_blocks_standby);
+  RUN_TEST(test_pending_checkpoint_blocks_standby);
+  return UNITY_END();
+}